@@ -0,0 +1,394 @@
+#ifndef COOL_ALLOCATORBENCHMARKS_H_
+#define COOL_ALLOCATORBENCHMARKS_H_
+
+#include <cool/Benchmark.h>
+#include <cool/ConcurrentSlabMemoryResource.h>
+#include <cool/PooledSlabMemoryResource.h>
+#include <cool/RelocatingVector.h>
+#include <cool/SlabAllocator.h>
+#include <cool/SlabString.h>
+#include <cool/default_init_allocator.h>
+#include <cool/ebo_allocator.h>
+#include <cool/make_unique_for_overwrite.h>
+#include <cool/memory_resource.h>
+#include <cool/resize_for_overwrite.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// AllocatorBenchmarks
+//
+//  Benchmarks comparing the cool allocators and memory resources against
+//  std::allocator and the pmr resources.  A benchmark program is just:
+//
+//      #include <cool/AllocatorBenchmarks.h>
+//      #include <iostream>
+//      int main() { cool::benchmark::allocators(std::cout); }
+//
+//  (compile with optimization and -pthread).  It reports, for each
+//  allocator:
+//
+//      allocate/deallocate - latency of single small allocate/deallocate pairs
+//      vector growth       - push_back n ints
+//      map churn           - insert n elements, erase half, reinsert (std::map)
+//      list churn          - push_back n, pop_front n, repeated (std::list)
+//      string building     - append n short pieces to a string
+//      threads             - allocate/deallocate pairs spread over 1..N threads
+//                            sharing one allocator
+//      fragmentation       - bytes taken from upstream while churning a
+//                            map after building it, per element (none for
+//                            a resource which reuses what is freed)
+//      slab statistics     - tail waste after one request larger than a slab,
+//                            and bytes requested growing two SlabStrings
+//                            alternately
+//
+//  as well as default_init_allocator and resize_for_overwrite vs. value
+//  initialization, make_unique_for_overwrite vs. make_unique, ebo_allocator
+//  overhead and RelocatingVector vs. std::vector growth.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+namespace benchmark
+{
+    // An upstream memory_resource which tracks how many bytes are outstanding
+    class CountingMemoryResource : public pmr::memory_resource
+    {
+    public:
+        size_t bytes() const noexcept { return m_bytes; }
+        size_t peak()  const noexcept { return m_peak; }
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            m_bytes += bytes;
+            m_peak   = std::max(m_peak, m_bytes);
+            return pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            m_bytes -= bytes;
+            pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const memory_resource& other) const noexcept override
+        { return this == &other; }
+
+        size_t m_bytes = 0;
+        size_t m_peak  = 0;
+    };
+
+    // Serializes a SlabMemoryResource with a mutex (how it has to be shared without
+    // ConcurrentSlabMemoryResource), for comparison in the threads benchmark
+    class MutexSlabMemoryResource
+    {
+    public:
+        constexpr static size_t defaultslabsize = SlabMemoryResource::defaultslabsize;
+
+        explicit MutexSlabMemoryResource(size_t slabsize = defaultslabsize)
+        : m_slabs{slabsize}
+        {}
+
+        template<typename T>
+        T* allocateUninitialized(size_t n = 1, size_t alignment = alignof(T))
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            return m_slabs.allocateUninitialized<T>(n, alignment);
+        }
+
+        template<typename T>
+        void deallocateUninitialized(T* /* p */, size_t /* n */ = 1, size_t /* alignment */ = alignof(T)) noexcept {}
+
+    private:
+        std::mutex         m_mutex;
+        SlabMemoryResource m_slabs;
+    };
+
+    namespace detail
+    {
+        template<typename A>
+        void allocateDeallocate(A a, size_t n)
+        {
+            using traits = std::allocator_traits<A>;
+            for (size_t i = 0; i != n; ++i)
+            {
+                auto p = traits::allocate(a, 1);
+                doNotOptimize(p);
+                traits::deallocate(a, p, 1);
+            }
+        }
+
+        template<typename A>
+        void vectorGrowth(A a, size_t n)
+        {
+            std::vector<int, A> v{a};
+            for (size_t i = 0; i != n; ++i)
+                v.push_back(static_cast<int>(i));
+            doNotOptimize(v.data());
+        }
+
+        template<typename A>
+        void mapChurn(A a, size_t n)
+        {
+            using value_type = std::pair<const size_t, size_t>;
+            using allocator  = typename std::allocator_traits<A>::template rebind_alloc<value_type>;
+
+            std::map<size_t, size_t, std::less<>, allocator> m{allocator(a)};
+            for (size_t i = 0; i != n; ++i)
+                m.emplace(i * 2654435761u % n, i);
+            for (size_t i = 0; i < n; i += 2)
+                m.erase(i * 2654435761u % n);
+            for (size_t i = 0; i < n; i += 2)
+                m.emplace(i * 2654435761u % n, i);
+            doNotOptimize(m.size());
+        }
+
+        template<typename A>
+        void listChurn(A a, size_t n)
+        {
+            std::list<int, A> l{a};
+            for (int round = 0; round != 4; ++round)
+            {
+                for (size_t i = 0; i != n / 4; ++i)
+                    l.push_back(static_cast<int>(i));
+                while (!l.empty())
+                    l.pop_front();
+            }
+            doNotOptimize(l.size());
+        }
+
+        template<typename A>
+        void stringBuilding(A a, size_t n)
+        {
+            using allocator = typename std::allocator_traits<A>::template rebind_alloc<char>;
+
+            std::basic_string<char, std::char_traits<char>, allocator> s{allocator(a)};
+            for (size_t i = 0; i != n; ++i)
+                s.append("piece ");
+            doNotOptimize(s.data());
+        }
+
+        // Run workload against each single threaded allocator
+        template<typename Workload>
+        void eachAllocator(std::ostream& os, const char* group, size_t n, Workload workload)
+        {
+            report(os, group, "std::allocator", measure([&]
+            { workload(std::allocator<int>{}, n); }), n);
+
+            report(os, group, "ebo_allocator<std::allocator>", measure([&]
+            { workload(ebo_allocator<std::allocator<int>>{}, n); }), n);
+
+            report(os, group, "SlabAllocator", measure([&]
+            { workload(SlabAllocator<int>{}, n); }), n);
+
+            report(os, group, "SlabRefAllocator", measure([&]
+            { SlabMemoryResource smr; workload(SlabRefAllocator<int>{smr}, n); }), n);
+
+            report(os, group, "SlabRefAllocator<Pooled>", measure([&]
+            { PooledSlabMemoryResource psmr; workload(SlabRefAllocator<int, PooledSlabMemoryResource>{psmr}, n); }), n);
+
+            report(os, group, "SlabRefAllocator<Concurrent>", measure([&]
+            { ConcurrentSlabMemoryResource csmr; workload(SlabRefAllocator<int, ConcurrentSlabMemoryResource>{csmr}, n); }), n);
+
+            report(os, group, "pmr::monotonic_buffer_resource", measure([&]
+            { pmr::monotonic_buffer_resource mbr; workload(pmr::polymorphic_allocator<int>{&mbr}, n); }), n);
+
+            report(os, group, "pmr::unsynchronized_pool_resource", measure([&]
+            { pmr::unsynchronized_pool_resource upr; workload(pmr::polymorphic_allocator<int>{&upr}, n); }), n);
+
+            report(os, group, "pmr::synchronized_pool_resource", measure([&]
+            { pmr::synchronized_pool_resource spr; workload(pmr::polymorphic_allocator<int>{&spr}, n); }), n);
+        }
+
+        // Run allocate/deallocate pairs over 1..maxthreads threads sharing an allocator
+        inline void threads(std::ostream& os, size_t n, unsigned maxthreads)
+        {
+            for (unsigned threads = 1; threads <= maxthreads; threads *= 2)
+            {
+                std::string group = "threads x" + std::to_string(threads);
+                size_t      each  = n / threads;
+
+                report(os, group, "std::allocator", measureThreads(threads, [&](unsigned)
+                { allocateDeallocate(std::allocator<int>{}, each); }), n);
+
+                report(os, group, "SlabAllocator<MutexSlabMemoryResource>", measure([&]
+                {
+                    SlabAllocator<int, MutexSlabMemoryResource> a;
+                    measureThreads(threads, [&](unsigned) { allocateDeallocate(a, each); }, 1);
+                }), n);
+
+                report(os, group, "SlabAllocator<Concurrent>", measure([&]
+                {
+                    SlabAllocator<int, ConcurrentSlabMemoryResource> a;
+                    measureThreads(threads, [&](unsigned) { allocateDeallocate(a, each); }, 1);
+                }), n);
+
+                report(os, group, "pmr::synchronized_pool_resource", measure([&]
+                {
+                    pmr::synchronized_pool_resource spr;
+                    measureThreads(threads, [&](unsigned) { allocateDeallocate(pmr::polymorphic_allocator<int>{&spr}, each); }, 1);
+                }), n);
+            }
+        }
+
+        // Upstream bytes taken while erasing and reinserting half of a map of
+        // n elements (four times), after building it
+        template<typename A>
+        size_t churnBytes(A a, CountingMemoryResource const& c, size_t n)
+        {
+            using value_type = std::pair<const size_t, size_t>;
+            using allocator  = typename std::allocator_traits<A>::template rebind_alloc<value_type>;
+
+            std::map<size_t, size_t, std::less<>, allocator> m{allocator(a)};
+            for (size_t i = 0; i != n; ++i)
+                m.emplace(i * 2654435761u % n, i);
+
+            size_t built{c.bytes()};
+            for (int round = 0; round != 4; ++round)
+            {
+                for (size_t i = 0; i < n; i += 2)
+                    m.erase(i * 2654435761u % n);
+                for (size_t i = 0; i < n; i += 2)
+                    m.emplace(i * 2654435761u % n, i);
+            }
+            doNotOptimize(m.size());
+
+            return c.bytes() - built;
+        }
+
+        // Upstream bytes taken by churn, per element
+        inline void fragmentation(std::ostream& os, size_t n)
+        {
+            auto line = [&](const char* name, size_t bytes)
+            {
+                os << std::left << std::setw(32) << "fragmentation" << std::setw(48) << name
+                   << std::right << std::setw(12) << bytes / std::max<size_t>(n, 1) << " bytes/element\n";
+            };
+
+            { CountingMemoryResource c; SlabMemoryResource r{SlabMemoryResource::defaultslabsize, &c};
+              line("SlabMemoryResource", churnBytes(SlabRefAllocator<int>{r}, c, n)); }
+
+            { CountingMemoryResource c; PooledSlabMemoryResource r{PooledSlabMemoryResource::defaultslabsize, &c};
+              line("PooledSlabMemoryResource", churnBytes(SlabRefAllocator<int, PooledSlabMemoryResource>{r}, c, n)); }
+
+            { CountingMemoryResource c; pmr::monotonic_buffer_resource r{&c};
+              line("pmr::monotonic_buffer_resource", churnBytes(pmr::polymorphic_allocator<int>{&r}, c, n)); }
+
+            { CountingMemoryResource c; pmr::unsynchronized_pool_resource r{&c};
+              line("pmr::unsynchronized_pool_resource", churnBytes(pmr::polymorphic_allocator<int>{&r}, c, n)); }
+        }
+
+        // default_init_allocator, make_unique_for_overwrite and ebo_allocator vs. their std counterparts
+        inline void initialization(std::ostream& os, size_t n)
+        {
+            report(os, "vector resize", "std::vector", measure([&]
+            { std::vector<int> v; v.resize(n); doNotOptimize(v.data()); }), n);
+
+            report(os, "vector resize", "default_init_vector", measure([&]
+            { default_init_vector<int> v; v.resize(n); doNotOptimize(v.data()); }), n);
+
+            report(os, "string resize", "std::string", measure([&]
+            { std::string s; s.resize(n); doNotOptimize(s.data()); }), n);
+
+            report(os, "string resize", resize_for_overwrite_is_uninitialized_v<std::string> ? "resize_for_overwrite"
+                                                                                             : "resize_for_overwrite (falls back to resize)", measure([&]
+            { std::string s; resize_for_overwrite(s, n); doNotOptimize(s.data()); }), n);
+
+            report(os, "unique_ptr<char[]>", "std::make_unique", measure([&]
+            { auto p = std::make_unique<char[]>(n); doNotOptimize(p.get()); }), n);
+
+            report(os, "unique_ptr<char[]>", "make_unique_for_overwrite", measure([&]
+            { auto p = make_unique_for_overwrite<char[]>(n); doNotOptimize(p.get()); }), n);
+
+            os << std::left << std::setw(32) << "sizeof" << std::setw(48) << "std::allocator<int>"
+               << std::right << std::setw(12) << sizeof(std::allocator<int>) << '\n'
+               << std::left << std::setw(32) << "sizeof" << std::setw(48) << "std::vector<int, ebo_allocator<std::allocator>>"
+               << std::right << std::setw(12) << sizeof(std::vector<int, ebo_allocator<std::allocator<int>>>) << '\n'
+               << std::left << std::setw(32) << "sizeof" << std::setw(48) << "std::vector<int>"
+               << std::right << std::setw(12) << sizeof(std::vector<int>) << '\n';
+        }
+
+        // Growing vectors of unique_ptr: moving each element vs. relocating them all at once
+        inline void relocation(std::ostream& os, size_t n)
+        {
+            report(os, "vector<unique_ptr> growth", "std::vector", measure([&]
+            {
+                std::vector<std::unique_ptr<int>> v;
+                for (size_t i = 0; i != n; ++i)
+                    v.emplace_back(nullptr);
+                doNotOptimize(v.data());
+            }), n);
+
+            report(os, "vector<unique_ptr> growth", "RelocatingVector", measure([&]
+            {
+                RelocatingVector<std::unique_ptr<int>> v;
+                for (size_t i = 0; i != n; ++i)
+                    v.emplace_back(nullptr);
+                doNotOptimize(v.data());
+            }), n);
+        }
+
+        // Slab bookkeeping for allocation patterns which used to waste space
+        inline void slabStatistics(std::ostream& os)
+        {
+            auto line = [&](const char* name, size_t value, const char* units)
+            {
+                os << std::left << std::setw(32) << "slab statistics" << std::setw(48) << name
+                   << std::right << std::setw(12) << value << ' ' << units << '\n';
+            };
+
+            // An oversized request gets its own allocation, and the current slab stays current
+            BasicSlabMemoryResource<SlabStatistics> r{1024};
+            r.allocateBytes(100);
+            r.allocateBytes(4096);
+            r.allocateBytes(100);
+            line("tail waste after oversized request", r.statistics().tailwaste, "bytes");
+            line("slabs after oversized request", r.statistics().slabs, "slabs");
+
+            // Neither string can extend in place while the other is after it,
+            // so each growth copies; doubling keeps that to a few copies
+            BasicSlabMemoryResource<SlabStatistics> s;
+            SlabString<BasicSlabMemoryResource<SlabStatistics>> a{s};
+            SlabString<BasicSlabMemoryResource<SlabStatistics>> b{s};
+            for (size_t i = 0; i != 10'000; ++i)
+            {
+                a.push_back('a');
+                b.push_back('b');
+            }
+            line("bytes requested by 2 alternating SlabStrings", s.statistics().bytesrequested, "bytes");
+            line("slabs for 2 alternating SlabStrings", s.statistics().slabs, "slabs");
+        }
+
+    } // detail namespace
+
+    // Run the whole suite, with n operations per benchmark
+    inline void allocators(std::ostream& os, size_t n = 1'000'000, unsigned maxthreads = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        detail::eachAllocator(os, "allocate/deallocate", n, [](auto a, size_t n) { detail::allocateDeallocate(a, n); });
+        detail::eachAllocator(os, "vector growth",       n, [](auto a, size_t n) { detail::vectorGrowth(a, n); });
+        detail::eachAllocator(os, "map churn",           n, [](auto a, size_t n) { detail::mapChurn(a, n); });
+        detail::eachAllocator(os, "list churn",          n, [](auto a, size_t n) { detail::listChurn(a, n); });
+        detail::eachAllocator(os, "string building",     n, [](auto a, size_t n) { detail::stringBuilding(a, n); });
+        detail::threads(os, n, maxthreads);
+        detail::fragmentation(os, n);
+        detail::initialization(os, n);
+        detail::relocation(os, n);
+        detail::slabStatistics(os);
+    }
+
+} // benchmark namespace
+} // cool namespace
+
+#endif /* COOL_ALLOCATORBENCHMARKS_H_ */
@@ -0,0 +1,94 @@
+#ifndef COOL_BENCHMARK_H_
+#define COOL_BENCHMARK_H_
+
+#include <cool/Stopwatch.h>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmark
+//
+//  Minimal helpers for writing benchmarks, built on Stopwatch.
+//
+//  doNotOptimize(value)
+//      keeps the compiler from optimizing away the computation of value
+//
+//  measure(f, repetitions = 5)
+//      calls f() repetitions times and returns the fastest duration
+//
+//  measureThreads(threads, f, repetitions = 5)
+//      calls f(thread) concurrently on threads threads (thread is
+//      0..threads-1), and returns the fastest wall clock duration
+//
+//  report(os, group, name, duration, operations)
+//      streams one line: group, name, total milliseconds and ns per operation
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+namespace benchmark
+{
+    using clock    = std::chrono::steady_clock;
+    using duration = clock::duration;
+
+    template<typename T>
+    inline void doNotOptimize(T const& value) noexcept
+    { asm volatile("" : : "r,m"(value) : "memory"); }
+
+    template<typename F>
+    duration measure(F&& f, unsigned repetitions = 5)
+    {
+        duration fastest = duration::max();
+        while (repetitions--)
+        {
+            Stopwatch<clock> stopwatch{true};
+            f();
+            fastest = std::min(fastest, stopwatch.lap());
+        }
+
+        return fastest;
+    }
+
+    template<typename F>
+    duration measureThreads(unsigned threads, F&& f, unsigned repetitions = 5)
+    {
+        return measure([&]
+        {
+            std::vector<std::thread> workers;
+            workers.reserve(threads);
+            for (unsigned thread = 0; thread != threads; ++thread)
+                workers.emplace_back([&f, thread] { f(thread); });
+
+            for (std::thread& worker : workers)
+                worker.join();
+        }, repetitions);
+    }
+
+    inline std::ostream& report(std::ostream& os, std::string_view group, std::string_view name, duration d, size_t operations)
+    {
+        using fmilliseconds = std::chrono::duration<double, std::milli>;
+        using fnanoseconds  = std::chrono::duration<double, std::nano>;
+
+        std::ios_base::fmtflags flags{os.flags()};
+        os << std::left  << std::setw(32) << group
+           << std::left  << std::setw(48) << name
+           << std::right << std::fixed << std::setprecision(3)
+           << std::setw(12) << fmilliseconds{d}.count() << " ms"
+           << std::setw(12) << fnanoseconds{d}.count() / std::max<size_t>(operations, 1) << " ns/op"
+           << '\n';
+        os.flags(flags);
+
+        return os;
+    }
+
+} // benchmark namespace
+} // cool namespace
+
+#endif /* COOL_BENCHMARK_H_ */
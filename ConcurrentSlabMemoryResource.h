@@ -0,0 +1,145 @@
+#ifndef COOL_CONCURRENTSLABMEMORYRESOURCE_H_
+#define COOL_CONCURRENTSLABMEMORYRESOURCE_H_
+
+#include <cool/SlabAllocator.h>
+#include <cool/memory_resource.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+///////////////////////////////////////////////////////////////////////////////
+// ConcurrentSlabMemoryResource
+//
+//  A thread safe SlabMemoryResource.  Each thread bump allocates from its
+//  own region (regionsize bytes) carved out of slabs shared by all threads,
+//  so the fast path takes no locks; only carving a new region (or serving a
+//  request too large for a region) locks the shared slabs.
+//
+//  Like SlabMemoryResource, deallocation is a no-op and all the slabs are
+//  released to upstream when the resource is destroyed.  upstream need not
+//  be thread safe, as it is only called while holding the lock.  Because
+//  threads cache their regions by resource, it is neither copyable nor
+//  moveable; share it via SlabAllocator<T, ConcurrentSlabMemoryResource>
+//  instead.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+class ConcurrentSlabMemoryResource : public pmr::memory_resource
+{
+public:
+    constexpr static size_t defaultslabsize   = SlabMemoryResource::defaultslabsize;
+    constexpr static size_t defaultregionsize = 64 * 1024;
+
+    explicit ConcurrentSlabMemoryResource(size_t                slabsize   = defaultslabsize,
+                                          size_t                regionsize = defaultregionsize,
+                                          pmr::memory_resource* upstream   = pmr::new_delete_resource()) noexcept
+    : m_regionsize{std::min(regionsize, slabsize)}
+    , m_slabs{slabsize, upstream}
+    {}
+
+    ConcurrentSlabMemoryResource(ConcurrentSlabMemoryResource const&)            = delete;
+    ConcurrentSlabMemoryResource& operator=(ConcurrentSlabMemoryResource const&) = delete;
+
+    void* allocateBytes(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        Region& region{localRegion()};
+
+        // Will the allocation fit in this thread's region?
+        if (void* allocated = std::align(alignment, size, region.free, region.space))
+        {
+            region.free   = static_cast<uint8_t*>(allocated) + size;
+            region.space -= size;
+
+            return allocated;
+        }
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        // Large requests come straight from the shared slabs,
+        // so they don't cause this thread to abandon its region
+        if (m_regionsize / 4 < size + alignment)
+            return m_slabs.allocateBytes(size, alignment);
+
+        // Carve out a new region for this thread
+        region.free  = m_slabs.allocateBytes(m_regionsize);
+        region.space = m_regionsize;
+
+        void* allocated{std::align(alignment, size, region.free, region.space)};
+        region.free   = static_cast<uint8_t*>(allocated) + size;
+        region.space -= size;
+
+        return allocated;
+    }
+
+    template<typename T>
+    T* allocateUninitialized(size_t n = 1, size_t alignment = alignof(T))
+    { return static_cast<T*>(allocateBytes(n * sizeof(T), alignment)); }
+
+    template<typename T>
+    void deallocateUninitialized(T* /* p */, size_t /* n */ = 1, size_t /* alignment */ = alignof(T)) noexcept {}
+
+    size_t regionsize() const noexcept
+    { return m_regionsize; }
+
+    pmr::memory_resource* upstream_resource() const noexcept
+    { return m_slabs.upstream_resource(); }
+
+private:
+    // pmr::memory_resource virtual functions
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    { return allocateBytes(bytes, alignment); }
+
+    void do_deallocate(void* /* p */, size_t /* bytes */, size_t /* alignment */) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+
+
+    // The part of a region a thread has yet to allocate from
+    struct Region
+    {
+        uint64_t id    = 0;
+        void*    free  = nullptr;
+        size_t   space = 0;
+    };
+
+    constexpr static size_t regioncachesize = 4;
+
+    // Each thread caches regions for the last few resources it allocated from.
+    // Ids are never reused, so entries for destroyed resources never match again.
+    Region& localRegion() noexcept
+    {
+        thread_local std::array<Region, regioncachesize> regions;
+        thread_local size_t                              victim{0};
+
+        for (Region& region : regions)
+        {
+            if (m_id == region.id)
+                return region;
+        }
+
+        Region& region{regions[victim++ % regions.size()]};
+        region = Region{m_id};
+
+        return region;
+    }
+
+    inline static std::atomic<uint64_t> s_ids{0};
+
+    const uint64_t     m_id{++s_ids};
+    const size_t       m_regionsize;
+    std::mutex         m_mutex;
+    SlabMemoryResource m_slabs;
+};
+
+} // cool namespace
+
+#endif /* COOL_CONCURRENTSLABMEMORYRESOURCE_H_ */
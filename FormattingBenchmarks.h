@@ -0,0 +1,389 @@
+#ifndef COOL_FORMATTINGBENCHMARKS_H_
+#define COOL_FORMATTINGBENCHMARKS_H_
+
+#include <cool/Benchmark.h>
+#include <cool/TextBuilder.h>
+#include <cool/c_str_t.h>
+#include <cool/to_cstring.h>
+#include <cool/to_cstrings.h>
+#include <cool/from_cstring.h>
+#include <cool/uuid_chars.h>
+#include <boost/uuid/uuid.hpp>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// FormattingBenchmarks
+//
+//  Benchmarks for formatting a column of n integers as comma separated text
+//  into one buffer.  A benchmark program is just:
+//
+//      #include <cool/FormattingBenchmarks.h>
+//      #include <iostream>
+//      int main() { cool::benchmark::formatting(std::cout); }
+//
+//  (compile with optimization).  The values have uniformly distributed
+//  digit counts, and for each of uint64_t and __int128_t it reports:
+//
+//      to_cstring      - a to_cstring per value, memcpy'ed into the buffer
+//      to_cstrings     - the bulk formatter, writing directly into the buffer
+//      std::to_chars   - (uint64_t only; __int128_t isn't portably integral)
+//      snprintf        - (uint64_t only)
+//
+//  and for n boost::uuids::uuids, formatting and parsing one at a time
+//  (scalar vs. the compiled in SIMD version from uuid_chars.h) and as a
+//  column with to_cstrings/from_cstrings.
+//
+//  It also formats n uint64_t with thousands separators and zero padded
+//  to a width, with to_cstring_options vs. std::ostringstream (with a
+//  numpunct facet, setw and setfill).
+//
+//  For c_str_t, it formats n int64_t in base 10 with the compact
+//  c_str_t<int64_t, 10> and with c_str_t<int64_t> (sized for base 2), and
+//  checks that every base from 2 to 36 round trips through from_cstring,
+//  reporting the number of mismatches (which should be 0).
+//
+//  Finally, it builds n log lines (a uuid, integers, a duration and some
+//  text) with FixedTextBuilder, TextBuilder, std::string + to_cstring and
+//  std::ostringstream.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+namespace benchmark
+{
+    namespace detail
+    {
+        // n values whose digit counts are spread evenly over those an I can have
+        template<typename I>
+        std::vector<I> formattingValues(size_t n)
+        {
+            std::vector<I> values;
+            values.reserve(n);
+
+            uint64_t state{0x9e3779b97f4a7c15u};
+            auto     next = [&state]
+            {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                return state;
+            };
+
+            constexpr unsigned bits{CHAR_BIT * sizeof(I) - cool::detail::is_to_cstring_signed_v<I>};
+            for (size_t i = 0; i != n; ++i)
+            {
+                using U = cool::detail::magnitude_t<I>;
+                U u{static_cast<U>(next())};
+                if constexpr(sizeof(uint64_t) < sizeof(U))
+                    u = u << 64 | next();
+                u >>= CHAR_BIT * sizeof(U) - 1 - next() % bits;
+                I value{static_cast<I>(u)};
+                values.push_back(cool::detail::is_to_cstring_signed_v<I> && next() % 2 ? I(-value) : value);
+            }
+
+            return values;
+        }
+
+        template<typename I>
+        void formatting(std::ostream& os, char const* group, size_t n)
+        {
+            std::vector<I>    values{formattingValues<I>(n)};
+            std::vector<char> buffer(to_cstrings_max_size<I>(n) + 1);
+
+            report(os, group, "to_cstring + memcpy", measure([&]
+            {
+                char* o{buffer.data()};
+                for (I value : values)
+                {
+                    to_cstring cs{value};
+                    std::memcpy(o, cs.data(), cs.size());
+                    o += cs.size();
+                    *o++ = ',';
+                }
+                doNotOptimize(o);
+            }), n);
+
+            report(os, group, "to_cstrings", measure([&]
+            {
+                size_t size{to_cstrings(values.data(), values.data() + values.size(), buffer.data())};
+                doNotOptimize(size);
+            }), n);
+
+            if constexpr(std::is_integral_v<I>)
+            {
+                report(os, group, "std::to_chars", measure([&]
+                {
+                    char* o{buffer.data()};
+                    char* last{buffer.data() + buffer.size()};
+                    for (I value : values)
+                    {
+                        o = std::to_chars(o, last, value).ptr;
+                        *o++ = ',';
+                    }
+                    doNotOptimize(o);
+                }), n);
+
+                report(os, group, "snprintf", measure([&]
+                {
+                    char* o{buffer.data()};
+                    char* last{buffer.data() + buffer.size()};
+                    for (I value : values)
+                    {
+                        o += std::snprintf(o, static_cast<size_t>(last - o), "%llu", static_cast<unsigned long long>(value));
+                        *o++ = ',';
+                    }
+                    doNotOptimize(o);
+                }), n);
+            }
+        }
+
+        inline void uuids(std::ostream& os, size_t n)
+        {
+            std::vector<boost::uuids::uuid> ids(n);
+            uint64_t                        state{0x9e3779b97f4a7c15u};
+            for (boost::uuids::uuid& id : ids)
+            {
+                for (uint8_t& byte : id)
+                {
+                    state = state * 6364136223846793005u + 1442695040888963407u;
+                    byte  = static_cast<uint8_t>(state >> 56);
+                }
+            }
+
+            std::vector<char> buffer(to_cstrings_max_size<boost::uuids::uuid>(n) + 1);
+
+            report(os, "format uuid", "scalar", measure([&]
+            {
+                char* o{buffer.data()};
+                for (boost::uuids::uuid const& id : ids)
+                    o = cool::detail::format_uuid_scalar(id.begin(), o);
+                doNotOptimize(o);
+            }), n);
+
+            report(os, "format uuid", "format_uuid", measure([&]
+            {
+                char* o{buffer.data()};
+                for (boost::uuids::uuid const& id : ids)
+                    o = cool::detail::format_uuid(id.begin(), o);
+                doNotOptimize(o);
+            }), n);
+
+            report(os, "format uuid", "to_cstrings", measure([&]
+            {
+                size_t size{to_cstrings(ids.data(), ids.data() + ids.size(), buffer.data())};
+                doNotOptimize(size);
+            }), n);
+
+            std::vector<boost::uuids::uuid> parsed(n);
+
+            report(os, "parse uuid", "scalar", measure([&]
+            {
+                char const* in{buffer.data()};
+                bool        valid{true};
+                for (boost::uuids::uuid& id : parsed)
+                {
+                    valid &= cool::detail::parse_uuid_scalar(in, id.begin());
+                    in += cool::detail::uuid_chars + sizeof(',');
+                }
+                doNotOptimize(valid);
+            }), n);
+
+            report(os, "parse uuid", "parse_uuid", measure([&]
+            {
+                char const* in{buffer.data()};
+                bool        valid{true};
+                for (boost::uuids::uuid& id : parsed)
+                {
+                    valid &= cool::detail::parse_uuid(in, id.begin());
+                    in += cool::detail::uuid_chars + sizeof(',');
+                }
+                doNotOptimize(valid);
+            }), n);
+
+            std::string_view column{buffer.data(), to_cstrings_max_size<boost::uuids::uuid>(n)};
+            report(os, "parse uuid", "from_cstrings", measure([&]
+            {
+                from_cstring_result<size_t> result{from_cstrings(column, parsed.data(), parsed.data() + parsed.size())};
+                doNotOptimize(result.value);
+            }), n);
+        }
+
+        inline void cStrT(std::ostream& os, size_t n)
+        {
+            std::vector<int64_t> values{formattingValues<int64_t>(n)};
+
+            report(os, "c_str_t", "c_str_t<int64_t, 10>", measure([&]
+            {
+                for (int64_t value : values)
+                    doNotOptimize(c_str_t<int64_t, 10>(value));
+            }), n);
+
+            report(os, "c_str_t", "c_str_t<int64_t>, base 10", measure([&]
+            {
+                for (int64_t value : values)
+                    doNotOptimize(c_str_t<int64_t>(value, 10));
+            }), n);
+
+            size_t mismatches{0};
+            for (int64_t value : values)
+            {
+                for (int base = 2; base <= 36; ++base)
+                {
+                    c_str_t<int64_t>             cs{value, base};
+                    from_cstring_result<int64_t> parsed{from_cstring<int64_t>(std::string_view(cs), base)};
+                    mismatches += !parsed || parsed.value != value || parsed.end != cs.size();
+                }
+            }
+
+            std::ios_base::fmtflags flags{os.flags()};
+            os << std::left  << std::setw(32) << "c_str_t"
+               << std::left  << std::setw(48) << "round trip mismatches, bases 2..36"
+               << std::right << std::setw(12) << mismatches << '\n';
+            os.flags(flags);
+        }
+
+        // Groups thousands with ','
+        struct thousands : std::numpunct<char>
+        {
+            char_type   do_thousands_sep() const override { return ','; }
+            string_type do_grouping()      const override { return "\3"; }
+        };
+
+        inline void options(std::ostream& os, size_t n)
+        {
+            std::vector<uint64_t> values{formattingValues<uint64_t>(n)};
+            using grouped = to_cstring_options<>::with_grouping<','>;
+            using padded  = to_cstring_options<>::with_width<20, '0'>;
+
+            report(os, "grouped", "to_cstring_options", measure([&]
+            {
+                for (uint64_t value : values)
+                    doNotOptimize(to_cstring(value, grouped{}));
+            }), n);
+
+            report(os, "grouped", "std::ostringstream + numpunct", measure([&]
+            {
+                std::ostringstream oss;
+                oss.imbue(std::locale(oss.getloc(), new thousands));
+                for (uint64_t value : values)
+                {
+                    oss.str({});
+                    oss << value;
+                    doNotOptimize(oss);
+                }
+            }), n);
+
+            report(os, "zero padded", "to_cstring_options", measure([&]
+            {
+                for (uint64_t value : values)
+                    doNotOptimize(to_cstring(value, padded{}));
+            }), n);
+
+            report(os, "zero padded", "std::ostringstream + setw", measure([&]
+            {
+                std::ostringstream oss;
+                for (uint64_t value : values)
+                {
+                    oss.str({});
+                    oss << std::setw(20) << std::setfill('0') << value;
+                    doNotOptimize(oss);
+                }
+            }), n);
+        }
+
+        template<typename Builder>
+        void buildLogLine(Builder& builder, boost::uuids::uuid const& id, size_t i)
+        {
+            builder << "request " << id << " item " << i << " of " << -static_cast<long>(i)
+                    << " took " << std::chrono::microseconds(static_cast<long>(i % 1000)) << '\n';
+        }
+
+        inline void logLines(std::ostream& os, size_t n)
+        {
+            boost::uuids::uuid id{};
+            for (uint8_t& byte : id)
+                byte = static_cast<uint8_t>(&byte - id.begin());
+
+            report(os, "log line", "FixedTextBuilder<256>", measure([&]
+            {
+                for (size_t i = 0; i != n; ++i)
+                {
+                    FixedTextBuilder<256> builder;
+                    buildLogLine(builder, id, i);
+                    doNotOptimize(builder);
+                }
+            }), n);
+
+            report(os, "log line", "TextBuilder (reused)", measure([&]
+            {
+                TextBuilder<> builder;
+                for (size_t i = 0; i != n; ++i)
+                {
+                    builder.clear();
+                    buildLogLine(builder, id, i);
+                    doNotOptimize(builder.data());
+                }
+            }), n);
+
+            report(os, "log line", "std::string + to_cstring", measure([&]
+            {
+                for (size_t i = 0; i != n; ++i)
+                {
+                    std::string s;
+                    s += "request ";
+                    s += std::string_view(to_cstring(id));
+                    s += " item ";
+                    s += std::string_view(to_cstring(i));
+                    s += " of ";
+                    s += std::string_view(to_cstring(-static_cast<long>(i)));
+                    s += " took ";
+                    s += std::string_view(to_cstring(static_cast<long>(i % 1000)));
+                    s += " microseconds\n";
+                    doNotOptimize(s.data());
+                }
+            }), n);
+
+            report(os, "log line", "std::ostringstream", measure([&]
+            {
+                for (size_t i = 0; i != n; ++i)
+                {
+                    std::ostringstream oss;
+                    oss << "request " << to_cstring(id) << " item " << i << " of " << -static_cast<long>(i)
+                        << " took " << i % 1000 << " microseconds\n";
+                    doNotOptimize(oss);
+                }
+            }), n);
+        }
+
+    } // detail namespace
+
+    // Run the whole suite, with n values per benchmark
+    inline void formatting(std::ostream& os, size_t n = 1'000'000)
+    {
+        detail::formatting<uint64_t>(os, "format uint64_t column", n);
+        detail::formatting<__int128_t>(os, "format __int128_t column", n);
+        detail::uuids(os, n);
+        detail::cStrT(os, n);
+        detail::options(os, n);
+        detail::logLines(os, n);
+    }
+
+} // benchmark namespace
+} // cool namespace
+
+#endif /* COOL_FORMATTINGBENCHMARKS_H_ */
@@ -0,0 +1,242 @@
+#ifndef COOL_MAPPEDFILEMEMORYRESOURCE_H_
+#define COOL_MAPPEDFILEMEMORYRESOURCE_H_
+
+#include <cool/memory_resource.h>
+#include <cool/unique_fd.h>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>       // align
+#include <new>          // bad_alloc
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>  // is_const
+#include <utility>      // as_const
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFileMemoryResource
+//
+//  A memory_resource which bump allocates from a file mapped into memory,
+//  so whatever is built in it persists in the file and can be mapped back in
+//  by another process with no deserialization.  It is intended as the
+//  upstream resource for a SlabMemoryResource:
+//
+//      cool::MappedFileMemoryResource file{"table.arena", 1 << 30};
+//      cool::SlabMemoryResource       smr{cool::SlabMemoryResource::defaultslabsize, &file};
+//      file.root(smr.create<Table>(...));
+//
+//  and in the next process:
+//
+//      cool::MappedFileMemoryResource file{"table.arena"};
+//      Table const* table = file.root<Table const>();
+//
+//  The file may be mapped at a different address each time, so the
+//  persisted data must contain no raw pointers or vtables, and must link to
+//  itself only with offset_ptr (or offsets).  The root is stored as an
+//  offset in the file, and a const MappedFileMemoryResource (like a
+//  readonly one) only hands it out as a pointer to const.
+//
+//  Modes:
+//      create    - create (or truncate) the file to capacity bytes
+//      readwrite - map an existing file, continuing to allocate after what
+//                  was allocated by the previous process
+//      readonly  - map an existing file read only; allocation throws
+//
+//  create is only for the (path, capacity) constructor; passing it to the
+//  (path, mode) constructor throws std::invalid_argument.
+//
+//  Deallocation is a no-op.  Allocation throws std::bad_alloc once the
+//  capacity of the file is exhausted; the mapping never moves.  Failures to
+//  open or map the file throw std::system_error, and a file which wasn't
+//  created by MappedFileMemoryResource throws std::runtime_error.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+class MappedFileMemoryResource : public pmr::memory_resource
+{
+public:
+    enum class Mode { create, readwrite, readonly };
+
+    // Create (or truncate) path to be capacity bytes
+    MappedFileMemoryResource(const char* path, size_t capacity)
+    : m_fd{create(path, capacity)}
+    , m_mode{Mode::create}
+    {
+        if (-1 == m_fd)
+            throwSystemError("open");
+
+        if (-1 == ftruncate(m_fd, static_cast<off_t>(capacity)))
+            throwSystemError("ftruncate");
+
+        map(capacity);
+        *header() = Header{};
+        header()->capacity = capacity;
+    }
+
+    // Map an existing file, either readwrite or readonly
+    explicit MappedFileMemoryResource(const char* path, Mode mode = Mode::readonly)
+    : m_fd{open(path, mode)}
+    , m_mode{mode}
+    {
+        if (-1 == m_fd)
+            throwSystemError("open");
+
+        struct stat st;
+        if (-1 == fstat(m_fd, &st))
+            throwSystemError("fstat");
+
+        // Validate before mapping, so there is nothing to unmap if we throw
+        Header h;
+        size_t size = static_cast<size_t>(st.st_size);
+        if (size < sizeof(Header) ||
+            sizeof(Header) != pread(m_fd, &h, sizeof(Header), 0) ||
+            Header::magicnumber != h.magic ||
+            size != h.capacity)
+            throw std::runtime_error("MappedFileMemoryResource: not an arena file");
+
+        map(size);
+    }
+
+    MappedFileMemoryResource(MappedFileMemoryResource const&)            = delete;
+    MappedFileMemoryResource& operator=(MappedFileMemoryResource const&) = delete;
+
+    ~MappedFileMemoryResource()
+    {
+        if (m_base)
+            munmap(m_base, m_size);
+    }
+
+    Mode mode() const noexcept
+    { return m_mode; }
+
+    size_t capacity() const noexcept
+    { return m_size; }
+
+    size_t used() const noexcept
+    { return header()->used; }
+
+    // The root object of whatever is stored in the file
+    void const* root() const noexcept
+    { return header()->root ? m_base + header()->root : nullptr; }
+
+    void* root() noexcept
+    {
+        assert(Mode::readonly != m_mode);
+        return const_cast<void*>(std::as_const(*this).root());
+    }
+
+    template<typename T>
+    T const* root() const noexcept
+    { return static_cast<T const*>(root()); }
+
+    // A readonly mapping can only be accessed through T const
+    template<typename T>
+    T* root() noexcept
+    {
+        assert(std::is_const_v<T> || Mode::readonly != m_mode);
+        return static_cast<T*>(const_cast<void*>(std::as_const(*this).root()));
+    }
+
+    void root(void const* p) noexcept
+    {
+        assert(Mode::readonly != m_mode);
+        assert(!p || (m_base <= p && p < m_base + m_size));
+
+        header()->root = p ? static_cast<uint8_t const*>(p) - m_base : 0;
+    }
+
+    // Flush the mapping to the file
+    void sync() const
+    {
+        if (-1 == msync(m_base, m_size, MS_SYNC))
+            throwSystemError("msync");
+    }
+
+private:
+    // pmr::memory_resource virtual functions
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (Mode::readonly == m_mode)
+            throw std::bad_alloc{};
+
+        void*  free  = m_base + header()->used;
+        size_t space = m_size - header()->used;
+        void*  allocated = std::align(alignment, bytes, free, space);
+        if (!allocated)
+            throw std::bad_alloc{};
+
+        header()->used = static_cast<uint8_t*>(allocated) + bytes - m_base;
+        return allocated;
+    }
+
+    void do_deallocate(void* /* p */, size_t /* bytes */, size_t /* alignment */) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+
+
+    // Stored at the beginning of the file
+    struct Header
+    {
+        constexpr static uint64_t magicnumber = 0x636f6f6c736c6162;    // "coolslab"
+
+        uint64_t magic    = magicnumber;
+        uint64_t capacity = 0;
+        uint64_t used     = sizeof(Header);
+        uint64_t root     = 0;
+    };
+
+    Header* header() const noexcept
+    { return reinterpret_cast<Header*>(m_base); }
+
+    void map(size_t size)
+    {
+        int   prot = Mode::readonly == m_mode ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* base = mmap(nullptr, size, prot, MAP_SHARED, m_fd, 0);
+        if (MAP_FAILED == base)
+            throwSystemError("mmap");
+
+        m_base = static_cast<uint8_t*>(base);
+        m_size = size;
+    }
+
+    // Opens path for the (path, capacity) constructor, checking capacity
+    // first so that an existing file isn't truncated when it will throw
+    static int create(const char* path, size_t capacity)
+    {
+        if (capacity < sizeof(Header))
+            throw std::bad_alloc{};
+
+        return ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    }
+
+    // Opens path for the (path, mode) constructor
+    static int open(const char* path, Mode mode)
+    {
+        if (Mode::create == mode)
+            throw std::invalid_argument("MappedFileMemoryResource: Mode::create needs a capacity");
+
+        return ::open(path, Mode::readonly == mode ? O_RDONLY : O_RDWR);
+    }
+
+    [[noreturn]] static void throwSystemError(const char* what)
+    { throw std::system_error(errno, std::generic_category(), what); }
+
+    unique_fd m_fd;
+    Mode      m_mode;
+    uint8_t*  m_base = nullptr;
+    size_t    m_size = 0;
+};
+
+} // cool namespace
+
+#endif /* COOL_MAPPEDFILEMEMORYRESOURCE_H_ */
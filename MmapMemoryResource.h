@@ -0,0 +1,106 @@
+#ifndef COOL_MMAPMEMORYRESOURCE_H_
+#define COOL_MMAPMEMORYRESOURCE_H_
+
+#include <cool/memory_resource.h>
+#include <cstddef>
+#include <new>          // bad_alloc
+#include <sys/mman.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+// MmapMemoryResource
+//
+//  A memory_resource which gets its memory directly from the OS via
+//  anonymous mmap, intended as the upstream resource for SlabMemoryResource.
+//
+//  Requests are rounded up to whole pages.  The OS hands back zero filled
+//  pages, so nothing is ever memset.
+//
+//  When hugepages is true and the request is a multiple of hugepagesize,
+//  it first tries explicit huge pages (MAP_HUGETLB), then falls back on
+//  ordinary pages advised to be transparent huge pages (MADV_HUGEPAGE).
+//  Either huge page facility is skipped if the platform doesn't have it.
+//
+//  Alignments greater than the page size are not supported and throw
+//  std::bad_alloc.
+//
+//  mmap_resource() returns a process wide instance which uses huge pages.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+class MmapMemoryResource : public pmr::memory_resource
+{
+public:
+    constexpr static size_t hugepagesize = 2 * 1024 * 1024;
+
+    explicit MmapMemoryResource(bool hugepages = true) noexcept
+    : m_hugepages{hugepages}
+    {}
+
+    static size_t pagesize() noexcept
+    {
+        static const size_t pagesize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return pagesize;
+    }
+
+    bool hugepages() const noexcept
+    { return m_hugepages; }
+
+private:
+    // pmr::memory_resource virtual functions
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (pagesize() < alignment)
+            throw std::bad_alloc{};
+
+        bytes = roundUp(bytes);
+        bool huge = m_hugepages && 0 == bytes % hugepagesize;
+
+#ifdef MAP_HUGETLB
+        if (huge)
+        {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (MAP_FAILED != p)
+                return p;
+        }
+#endif
+
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == p)
+            throw std::bad_alloc{};
+
+#ifdef MADV_HUGEPAGE
+        if (huge)
+            madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t /* alignment */) override
+    { munmap(p, roundUp(bytes)); }
+
+    // Any MmapMemoryResource can munmap what another one mmapped
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    { return dynamic_cast<MmapMemoryResource const*>(&other); }
+
+
+    static size_t roundUp(size_t bytes) noexcept
+    { return (bytes + pagesize() - 1) / pagesize() * pagesize(); }
+
+    bool m_hugepages;
+};
+
+inline MmapMemoryResource* mmap_resource() noexcept
+{
+    static MmapMemoryResource mmapmemoryresource{true};
+    return &mmapmemoryresource;
+}
+
+} // cool namespace
+
+#endif /* COOL_MMAPMEMORYRESOURCE_H_ */
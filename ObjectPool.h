@@ -0,0 +1,248 @@
+#ifndef COOL_OBJECTPOOL_H_
+#define COOL_OBJECTPOOL_H_
+
+#include <cool/SlabAllocator.h>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjectPool<T, R, IndexBits>
+//
+//  A fixed capacity pool of T, with storage allocated from a slab memory
+//  resource R (default SlabMemoryResource), which must outlive the pool.
+//
+//  acquire() constructs a T and returns a Handle to it; release() destroys
+//  it.  Both are O(1).  Live objects are kept densely packed (release()
+//  moves the last object into the hole), so begin()/end() iterate over
+//  exactly the live objects in contiguous memory.  Because objects move,
+//  hold on to Handles, not pointers, across a release().
+//
+//  A Handle is 32 bits:  IndexBits bits of slot index (which bounds the
+//  capacity) and the rest a generation count which is bumped every time the
+//  slot is released.  get() returns nullptr for a Handle whose object has
+//  been released, detecting use after free (until the generation wraps).
+//  A default constructed Handle never refers to anything.
+//
+//  acquire() throws std::bad_alloc when the pool is full, as does the
+//  constructor when capacity is more than max_capacity.  The storage is
+//  given back to R when the pool is destroyed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+template<typename T, typename R = SlabMemoryResource, unsigned IndexBits = 20>
+class ObjectPool
+{
+    static_assert(0 < IndexBits && IndexBits < 32);
+    static_assert(std::is_nothrow_move_constructible_v<T>, "release() moves objects to keep them dense");
+
+public:
+    using value_type     = T;
+    using iterator       = T*;
+    using const_iterator = T const*;
+    using size_type      = std::size_t;
+
+    constexpr static uint32_t max_capacity = uint32_t(1) << IndexBits;
+
+    class Handle
+    {
+    public:
+        constexpr Handle() noexcept = default;
+
+        constexpr uint32_t value() const noexcept { return m_value; }
+
+        constexpr friend bool operator==(Handle l, Handle r) noexcept { return l.m_value == r.m_value; }
+        constexpr friend bool operator!=(Handle l, Handle r) noexcept { return !(l == r); }
+
+    private:
+        friend class ObjectPool;
+
+        constexpr Handle(uint32_t slot, uint32_t generation) noexcept
+        : m_value{generation << IndexBits | slot}
+        {}
+
+        constexpr uint32_t slot()       const noexcept { return m_value & (max_capacity - 1); }
+        constexpr uint32_t generation() const noexcept { return m_value >> IndexBits; }
+
+        uint32_t m_value = 0;
+    };
+
+    ObjectPool(size_type capacity, R& smr)
+    : m_smr{&smr}
+    , m_capacity{checkedCapacity(capacity)}
+    {
+        try
+        {
+            m_dense      = smr.template allocateUninitialized<T>(capacity);
+            m_denseslots = smr.template allocateUninitialized<uint32_t>(capacity);
+            m_slots      = smr.template allocateUninitialized<Slot>(capacity);
+        }
+        catch (...)
+        {
+            deallocate();
+            throw;
+        }
+    }
+
+    ObjectPool(ObjectPool const&)            = delete;
+    ObjectPool& operator=(ObjectPool const&) = delete;
+
+    ~ObjectPool()
+    {
+        clear();
+        deallocate();
+    }
+
+    template<typename... Args>
+    Handle acquire(Args&&... args)
+    {
+        if (m_size == m_capacity)
+            throw std::bad_alloc{};
+
+        // Reuse a released slot, or start using a fresh one
+        uint32_t slot = m_freeslot;
+        if (nil != slot)
+            m_freeslot = m_slots[slot].index;
+        else
+        {
+            slot = m_slotsused++;
+            m_slots[slot].generation = 1;
+        }
+
+        try
+        {
+            ::new (static_cast<void*>(m_dense + m_size)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            m_slots[slot].index = m_freeslot;
+            m_freeslot = slot;
+            throw;
+        }
+
+        m_slots[slot].index = m_size;
+        m_denseslots[m_size] = slot;
+        ++m_size;
+
+        return Handle{slot, m_slots[slot].generation};
+    }
+
+    // Release the object referred to by handle (a no-op if it was already released)
+    void release(Handle handle) noexcept
+    {
+        if (!get(handle))
+            return;
+
+        uint32_t slot  = handle.slot();
+        uint32_t index = m_slots[slot].index;
+        uint32_t last  = --m_size;
+
+        m_dense[index].~T();
+        if (index != last)
+        {
+            // Move the last object into the hole to stay dense
+            ::new (static_cast<void*>(m_dense + index)) T(std::move(m_dense[last]));
+            m_dense[last].~T();
+
+            m_denseslots[index] = m_denseslots[last];
+            m_slots[m_denseslots[index]].index = index;
+        }
+
+        // Bump the generation (skipping 0) to invalidate outstanding handles
+        uint32_t generation = (m_slots[slot].generation + 1) & (~uint32_t(0) >> IndexBits);
+        m_slots[slot].generation = generation ? generation : 1;
+        m_slots[slot].index      = m_freeslot;
+        m_freeslot               = slot;
+    }
+
+    // Release every object
+    void clear() noexcept
+    {
+        while (m_size)
+            release(handle(m_size - 1));
+    }
+
+    // Returns nullptr if the object referred to by handle has been released
+    T* get(Handle handle) noexcept
+    { return const_cast<T*>(std::as_const(*this).get(handle)); }
+
+    T const* get(Handle handle) const noexcept
+    {
+        uint32_t slot = handle.slot();
+        if (m_slotsused <= slot || m_slots[slot].generation != handle.generation())
+            return nullptr;
+
+        return m_dense + m_slots[slot].index;
+    }
+
+    bool contains(Handle handle) const noexcept
+    { return get(handle); }
+
+    // The handle of the object at position index of the dense iteration
+    Handle handle(size_type index) const noexcept
+    {
+        assert(index < m_size);
+
+        uint32_t slot = m_denseslots[index];
+        return Handle{slot, m_slots[slot].generation};
+    }
+
+    // iterator support (over the live objects)
+    iterator       begin()        noexcept { return m_dense; }
+    iterator       end()          noexcept { return m_dense + m_size; }
+    const_iterator begin()  const noexcept { return m_dense; }
+    const_iterator end()    const noexcept { return m_dense + m_size; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+    // capacity
+    size_type size()     const noexcept { return m_size; }
+    bool      empty()    const noexcept { return !m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+
+private:
+    // index is the dense index of a live slot, or the next free slot of a released one
+    struct Slot
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    constexpr static uint32_t nil = ~uint32_t(0);
+
+    // Slot indices must fit in IndexBits
+    static uint32_t checkedCapacity(size_type capacity)
+    {
+        if (max_capacity < capacity)
+            throw std::bad_alloc{};
+
+        return static_cast<uint32_t>(capacity);
+    }
+
+    // Give the storage (whatever of it was allocated) back to R
+    void deallocate() noexcept
+    {
+        m_smr->template deallocateUninitialized<Slot>(m_slots, m_capacity);
+        m_smr->template deallocateUninitialized<uint32_t>(m_denseslots, m_capacity);
+        m_smr->template deallocateUninitialized<T>(m_dense, m_capacity);
+    }
+
+    R*        m_smr;
+    uint32_t  m_capacity;
+    uint32_t  m_size       = 0;
+    uint32_t  m_slotsused  = 0;
+    uint32_t  m_freeslot   = nil;
+    T*        m_dense      = nullptr;
+    uint32_t* m_denseslots = nullptr;
+    Slot*     m_slots      = nullptr;
+};
+
+} // cool namespace
+
+#endif /* COOL_OBJECTPOOL_H_ */
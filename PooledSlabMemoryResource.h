@@ -0,0 +1,179 @@
+#ifndef COOL_POOLEDSLABMEMORYRESOURCE_H_
+#define COOL_POOLEDSLABMEMORYRESOURCE_H_
+
+#include <cool/SlabAllocator.h>
+#include <cool/memory_resource.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+// PooledSlabMemoryResource
+//
+//  A SlabMemoryResource which recycles deallocated memory.
+//
+//  Small requests (up to maxpooledsize bytes, with alignment no greater than
+//  granularity) are rounded up to a size class.  Deallocated blocks are kept
+//  on an intrusive free list per size class, and allocation pops from that
+//  list, only falling back on bump allocating fresh memory from the slabs
+//  when the list is empty.
+//
+//  Size classes are multiples of granularity up to 256 bytes, then powers
+//  of two up to maxpooledsize.
+//
+//  Larger (or over-aligned) requests are bump allocated from the slabs and,
+//  like SlabMemoryResource, not recycled until the resource is reset() or
+//  destroyed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+namespace detail
+{
+    template<size_t Granularity, size_t MaxSize>
+    struct SlabSizeClasses
+    {
+        constexpr static size_t linearclasses = 256 / Granularity;
+
+        static constexpr size_t sizeClass(size_t size) noexcept
+        {
+            if (size <= linearclasses * Granularity)
+                return size ? (size - 1) / Granularity : 0;
+
+            size_t sizeclass = linearclasses;
+            for (size_t classsize = 2 * linearclasses * Granularity; classsize < size; classsize *= 2)
+                ++sizeclass;
+
+            return sizeclass;
+        }
+
+        static constexpr size_t classSize(size_t sizeclass) noexcept
+        {
+            return sizeclass < linearclasses
+                ? (sizeclass + 1) * Granularity
+                : (2 * linearclasses * Granularity) << (sizeclass - linearclasses);
+        }
+
+        constexpr static size_t sizeclasses = sizeClass(MaxSize) + 1;
+
+        static_assert(classSize(sizeClass(MaxSize)) == MaxSize, "MaxSize must be a size class");
+    };
+
+} // detail namespace
+
+class PooledSlabMemoryResource : public pmr::memory_resource
+{
+public:
+    constexpr static size_t defaultslabsize = SlabMemoryResource::defaultslabsize;
+    constexpr static size_t granularity     = alignof(std::max_align_t);
+    constexpr static size_t maxpooledsize   = 64 * 1024;
+
+    explicit PooledSlabMemoryResource(size_t slabsize = defaultslabsize, pmr::memory_resource* upstream = pmr::new_delete_resource()) noexcept
+    : m_slabs{slabsize, upstream}
+    {}
+
+    // Make it moveable
+    PooledSlabMemoryResource(PooledSlabMemoryResource&& that) noexcept
+    : PooledSlabMemoryResource{that.slabsize(), that.upstream_resource()}
+    { swap(*this, that); }
+
+    PooledSlabMemoryResource& operator=(PooledSlabMemoryResource&& that) noexcept
+    { swap(*this, that); return *this; }
+
+    // Make it swappable (since we use swap for moving)
+    friend void swap(PooledSlabMemoryResource& l, PooledSlabMemoryResource& r) noexcept
+    {
+        using std::swap;
+
+        swap(l.m_slabs,     r.m_slabs);
+        swap(l.m_freelists, r.m_freelists);
+    }
+
+    void* allocateBytes(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        if (!isPooled(size, alignment))
+            return m_slabs.allocateBytes(size, alignment);
+
+        size_t sizeclass = sizeClass(size);
+        if (Node* node = m_freelists[sizeclass])
+        {
+            m_freelists[sizeclass] = node->next;
+            return node;
+        }
+
+        return m_slabs.allocateBytes(classSize(sizeclass), granularity);
+    }
+
+    void deallocateBytes(void* p, size_t size, size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        if (!p || !isPooled(size, alignment))
+            return;
+
+        size_t sizeclass = sizeClass(size);
+        m_freelists[sizeclass] = ::new (p) Node{m_freelists[sizeclass]};
+    }
+
+    template<typename T>
+    T* allocateUninitialized(size_t n = 1, size_t alignment = alignof(T))
+    { return static_cast<T*>(allocateBytes(n * sizeof(T), alignment)); }
+
+    template<typename T>
+    void deallocateUninitialized(T* p, size_t n = 1, size_t alignment = alignof(T)) noexcept
+    { deallocateBytes(p, n * sizeof(T), alignment); }
+
+    // Release everything allocated
+    // The slabs are kept for reuse by subsequent allocations
+    void reset() noexcept
+    {
+        m_slabs.reset();
+        m_freelists = FreeLists{};
+    }
+
+    size_t slabsize() const noexcept
+    { return m_slabs.slabsize(); }
+
+    pmr::memory_resource* upstream_resource() const noexcept
+    { return m_slabs.upstream_resource(); }
+
+private:
+    // pmr::memory_resource virtual functions
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    { return allocateBytes(bytes, alignment); }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    { deallocateBytes(p, bytes, alignment); }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+
+
+    using SizeClasses = detail::SlabSizeClasses<granularity, maxpooledsize>;
+
+    static constexpr bool isPooled(size_t size, size_t alignment) noexcept
+    { return size <= maxpooledsize && alignment <= granularity; }
+
+    static constexpr size_t sizeClass(size_t size) noexcept
+    { return SizeClasses::sizeClass(size); }
+
+    static constexpr size_t classSize(size_t sizeclass) noexcept
+    { return SizeClasses::classSize(sizeclass); }
+
+    struct Node
+    {
+        Node* next;
+    };
+
+    struct FreeLists : std::array<Node*, SizeClasses::sizeclasses> {};
+
+    SlabMemoryResource m_slabs;
+    FreeLists          m_freelists{};
+};
+
+} // cool namespace
+
+#endif /* COOL_POOLEDSLABMEMORYRESOURCE_H_ */
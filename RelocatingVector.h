@@ -0,0 +1,379 @@
+#ifndef COOL_RELOCATINGVECTOR_H_
+#define COOL_RELOCATINGVECTOR_H_
+
+#include <cool/is_trivially_relocatable.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+// RelocatingVector<T>
+//
+//  A vector which relocates (see is_trivially_relocatable.h) its elements
+//  when it grows, inserts or erases, instead of moving and destroying them
+//  one at a time.
+//
+//  When T is trivially relocatable, its buffer is malloc'ed and grows with
+//  realloc (which may extend it in place, and otherwise is a single memcpy),
+//  and insert/erase shift elements with a single memmove.  So growing a
+//  RelocatingVector<std::unique_ptr<U>> never touches the unique_ptrs.
+//  Otherwise, it behaves like std::vector with std::allocator, with the
+//  same exception guarantees:  growing moves elements only if that can't
+//  throw (move_if_noexcept), otherwise copying them and keeping the old
+//  buffer until that succeeds, and erase move assigns the later elements.
+//
+//  The interface is a subset of std::vector.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+template<typename T>
+class RelocatingVector
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc must be able to align T");
+
+public:
+    // types
+    using value_type             = T;
+    using pointer                = T*;
+    using const_pointer          = T const*;
+    using reference              = T&;
+    using const_reference        = T const&;
+    using iterator               = pointer;
+    using const_iterator         = const_pointer;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    // construct/copy/destroy
+    constexpr RelocatingVector() noexcept = default;
+
+    RelocatingVector(std::initializer_list<T> il)
+    { append(il.begin(), il.end()); }
+
+    RelocatingVector(RelocatingVector const& that)
+    { append(that.begin(), that.end()); }
+
+    RelocatingVector(RelocatingVector&& that) noexcept
+    : m_data{std::exchange(that.m_data, nullptr)}
+    , m_size{std::exchange(that.m_size, 0)}
+    , m_capacity{std::exchange(that.m_capacity, 0)}
+    {}
+
+    RelocatingVector& operator=(RelocatingVector const& that)
+    {
+        if (this != &that)
+        {
+            clear();
+            append(that.begin(), that.end());
+        }
+
+        return *this;
+    }
+
+    RelocatingVector& operator=(RelocatingVector&& that) noexcept
+    { swap(*this, that); return *this; }
+
+    ~RelocatingVector()
+    {
+        clear();
+        std::free(m_data);
+    }
+
+    // iterators
+    iterator               begin()         noexcept { return m_data; }
+    iterator               end()           noexcept { return m_data + m_size; }
+    const_iterator         begin()   const noexcept { return m_data; }
+    const_iterator         end()     const noexcept { return m_data + m_size; }
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator{end()}; }
+    reverse_iterator       rend()          noexcept { return reverse_iterator{begin()}; }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator{end()}; }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator{begin()}; }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // capacity
+    bool      empty()    const noexcept { return !m_size; }
+    size_type size()     const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+
+    void reserve(size_type n)
+    {
+        if (m_capacity < n)
+            reallocate(n);
+    }
+
+    void resize(size_type n)
+    {
+        reserve(n);
+        while (m_size < n)
+            emplace_back();
+        while (n < m_size)
+            pop_back();
+    }
+
+    void resize(size_type n, T const& value)
+    {
+        reserve(n);
+        while (m_size < n)
+            push_back(value);
+        while (n < m_size)
+            pop_back();
+    }
+
+    void shrink_to_fit()
+    {
+        if (m_size != m_capacity)
+            reallocate(m_size);
+    }
+
+    // element access
+    reference       operator[](size_type n)       noexcept { assert(n < m_size); return m_data[n]; }
+    const_reference operator[](size_type n) const noexcept { assert(n < m_size); return m_data[n]; }
+    reference       at(size_type n)                        { check(n); return m_data[n]; }
+    const_reference at(size_type n)               const    { check(n); return m_data[n]; }
+    reference       front()                       noexcept { return (*this)[0]; }
+    const_reference front()                 const noexcept { return (*this)[0]; }
+    reference       back()                        noexcept { return (*this)[m_size - 1]; }
+    const_reference back()                  const noexcept { return (*this)[m_size - 1]; }
+
+    // data access
+    T*       data()       noexcept { return m_data; }
+    T const* data() const noexcept { return m_data; }
+
+    // modifiers
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            // args may refer to elements, which growing might free
+            T t(std::forward<Args>(args)...);
+            reallocate(grownCapacity(m_size + 1));
+            ::new (static_cast<void*>(m_data + m_size)) T(std::move(t));
+        }
+        else
+            ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+
+        return m_data[m_size++];
+    }
+
+    void push_back(T const& t) { emplace_back(t); }
+    void push_back(T&& t)      { emplace_back(std::move(t)); }
+
+    void pop_back() noexcept
+    {
+        assert(m_size);
+        m_data[--m_size].~T();
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator position, Args&&... args)
+    {
+        size_type index = static_cast<size_type>(position - begin());
+        if (index == m_size)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return m_data + index;
+        }
+
+        // Construct first, as args may refer to elements which are about to move
+        alignas(T) unsigned char storage[sizeof(T)];
+        T* t = ::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+        if constexpr(is_trivially_relocatable_v<T>)
+        {
+            if (m_size == m_capacity)
+            {
+                try
+                {
+                    reallocate(grownCapacity(m_size + 1));
+                }
+                catch (...)
+                {
+                    t->~T();
+                    throw;
+                }
+            }
+
+            // Open a hole at index (a memmove, which can't throw) and relocate t into it
+            shift(index, 1);
+            relocate_at(t, m_data + index);
+        }
+        else
+        {
+            // Moves may throw, so (as std::vector does) move the last element
+            // into the new end and the rest back by one, leaving every element
+            // valid whatever throws; t is destroyed either way
+            try
+            {
+                if (m_size == m_capacity)
+                    reallocate(grownCapacity(m_size + 1));
+
+                ::new (static_cast<void*>(m_data + m_size)) T(std::move(m_data[m_size - 1]));
+                ++m_size;
+                std::move_backward(m_data + index, m_data + m_size - 2, m_data + m_size - 1);
+                m_data[index] = std::move(*t);
+            }
+            catch (...)
+            {
+                t->~T();
+                throw;
+            }
+            t->~T();
+        }
+
+        return m_data + index;
+    }
+
+    iterator insert(const_iterator position, T const& t) { return emplace(position, t); }
+    iterator insert(const_iterator position, T&& t)      { return emplace(position, std::move(t)); }
+
+    iterator erase(const_iterator position)
+    { return erase(position, position + 1); }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        size_type index = static_cast<size_type>(first - begin());
+        size_type n     = static_cast<size_type>(last - first);
+
+        if constexpr(is_trivially_relocatable_v<T>)
+        {
+            std::destroy_n(m_data + index, n);
+            uninitialized_relocate(m_data + index + n, end(), m_data + index);
+        }
+        else
+        {
+            // A throwing move assignment leaves every element valid
+            std::move(m_data + index + n, end(), m_data + index);
+            std::destroy(end() - n, end());
+        }
+        m_size -= n;
+
+        return m_data + index;
+    }
+
+    template<typename InputIterator>
+    void append(InputIterator first, InputIterator last)
+    {
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>)
+        {
+            size_type n = static_cast<size_type>(std::distance(first, last));
+            if (m_capacity < m_size + n)
+                reallocate(grownCapacity(m_size + n));
+
+            std::uninitialized_copy(first, last, m_data + m_size);
+            m_size += n;
+        }
+        else
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+    }
+
+    void clear() noexcept
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    friend void swap(RelocatingVector& l, RelocatingVector& r) noexcept
+    {
+        using std::swap;
+
+        swap(l.m_data,     r.m_data);
+        swap(l.m_size,     r.m_size);
+        swap(l.m_capacity, r.m_capacity);
+    }
+
+    // comparisons
+    friend bool operator==(RelocatingVector const& l, RelocatingVector const& r)
+    { return std::equal(l.begin(), l.end(), r.begin(), r.end()); }
+
+    friend bool operator!=(RelocatingVector const& l, RelocatingVector const& r)
+    { return !(l == r); }
+
+private:
+    void check(size_type n) const
+    {
+        if (m_size <= n)
+            throw std::out_of_range("RelocatingVector");
+    }
+
+    // Double the capacity, but at least enough to hold n
+    size_type grownCapacity(size_type n) const noexcept
+    { return std::max(n, 2 * m_capacity); }
+
+    void reallocate(size_type capacity)
+    {
+        if (capacity < m_size || (~size_type(0)) / sizeof(T) < capacity)
+            throw std::length_error("RelocatingVector");
+
+        T* data;
+        if constexpr(is_trivially_relocatable_v<T>)
+        {
+            // realloc copies the bytes if it can't grow in place
+            data = static_cast<T*>(capacity ? std::realloc(static_cast<void*>(m_data), capacity * sizeof(T)) : nullptr);
+            if (capacity && !data)
+                throw std::bad_alloc{};
+            if (!capacity)
+                std::free(m_data);
+        }
+        else
+        {
+            data = static_cast<T*>(capacity ? std::malloc(capacity * sizeof(T)) : nullptr);
+            if (capacity && !data)
+                throw std::bad_alloc{};
+
+            // The old elements stay intact until the new ones are all constructed
+            try
+            {
+                if constexpr(std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                    std::uninitialized_move_n(m_data, m_size, data);
+                else
+                    std::uninitialized_copy_n(m_data, m_size, data);
+            }
+            catch (...)
+            {
+                std::free(data);
+                throw;
+            }
+            std::destroy_n(m_data, m_size);
+            std::free(m_data);
+        }
+
+        m_data     = data;
+        m_capacity = capacity;
+    }
+
+    // Relocate the elements from index on, n positions later (there must be room)
+    void shift(size_type index, size_type n)
+    {
+        uninitialized_relocate(m_data + index, end(), m_data + index + n);
+        m_size += n;
+    }
+
+    T*        m_data     = nullptr;
+    size_type m_size     = 0;
+    size_type m_capacity = 0;
+};
+
+template<typename T>
+struct is_trivially_relocatable<RelocatingVector<T>> : std::true_type {};
+
+} // cool namespace
+
+#endif /* COOL_RELOCATINGVECTOR_H_ */
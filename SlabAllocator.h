@@ -1,70 +1,337 @@
 #ifndef COOL_SLABALLOCATOR_H_
 #define COOL_SLABALLOCATOR_H_
 
+#include <cool/ebo_wrapper.h>
 #include <cool/memory_resource.h>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <numeric>
+#include <ostream>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace cool
 {
 
-class SlabMemoryResource : public pmr::memory_resource
+///////////////////////////////////////////////////////////////////////////////
+// Slab statistics policies
+//
+//  The Statistics template parameter of BasicSlabMemoryResource is told
+//  about every allocation and slab change.
+//
+//  NoSlabStatistics records nothing and costs nothing; it is the default
+//  (SlabMemoryResource is BasicSlabMemoryResource<NoSlabStatistics>).
+//
+//  SlabStatistics records:
+//      bytesrequested    - total bytes requested by allocations
+//      bytesreserved     - total bytes of slabs acquired from upstream
+//      slabs             - number of slabs acquired from upstream
+//      tailwaste         - space left at the end of slabs abandoned for another slab
+//      alignmentwaste    - padding inserted to align allocations
+//      largestallocation - largest single request
+//      largeallocations  - number of requests allocated directly from upstream
+//      inuse             - bytes currently consumed (allocations, padding and tail waste)
+//      highwatermark     - largest inuse seen
+//
+//  All but inuse are cumulative (they are not reduced by rewind() or reset()).
+//  It can be streamed, either directly or through cool::Out.
+//
+///////////////////////////////////////////////////////////////////////////////
+struct NoSlabStatistics
+{
+    constexpr static bool enabled = false;
+
+    void allocated(size_t /* size */, size_t /* padding */) noexcept {}
+    void largeAllocated(size_t /* size */) noexcept {}
+    void nextSlab(size_t /* tail */, size_t /* slabsize */, bool /* acquired */) noexcept {}
+    void rewound(size_t /* inuse */) noexcept {}
+};
+
+struct SlabStatistics
+{
+    constexpr static bool enabled = true;
+
+    size_t bytesrequested    = 0;
+    size_t bytesreserved     = 0;
+    size_t slabs             = 0;
+    size_t tailwaste         = 0;
+    size_t alignmentwaste    = 0;
+    size_t largestallocation = 0;
+    size_t largeallocations  = 0;
+    size_t inuse             = 0;
+    size_t highwatermark     = 0;
+
+    void allocated(size_t size, size_t padding) noexcept
+    {
+        bytesrequested    += size;
+        alignmentwaste    += padding;
+        largestallocation  = std::max(largestallocation, size);
+        inuse             += size + padding;
+        highwatermark      = std::max(highwatermark, inuse);
+    }
+
+    void largeAllocated(size_t size) noexcept
+    {
+        ++largeallocations;
+        bytesreserved += size;
+        allocated(size, 0);
+    }
+
+    void nextSlab(size_t tail, size_t slabsize, bool acquired) noexcept
+    {
+        tailwaste += tail;
+        inuse     += tail;
+
+        if (acquired)
+        {
+            bytesreserved += slabsize;
+            ++slabs;
+        }
+    }
+
+    void rewound(size_t bytes) noexcept
+    { inuse = bytes; }
+
+    friend std::ostream& operator<<(std::ostream& os, SlabStatistics const& that)
+    {
+        return os
+            << "{bytesrequested="    << that.bytesrequested
+            << ",bytesreserved="     << that.bytesreserved
+            << ",slabs="             << that.slabs
+            << ",tailwaste="         << that.tailwaste
+            << ",alignmentwaste="    << that.alignmentwaste
+            << ",largestallocation=" << that.largestallocation
+            << ",largeallocations="  << that.largeallocations
+            << ",inuse="             << that.inuse
+            << ",highwatermark="     << that.highwatermark
+            << '}'
+            ;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SlabOptions
+//
+//  How BasicSlabMemoryResource sizes its slabs and handles large requests.
+//  The defaults give fixed size slabs.
+//
+//      slabsize    - size of the first slab
+//      growth      - each slab acquired from upstream is growth times the
+//                    size of the previous one (1 means fixed size slabs)...
+//      maxslabsize - ...up to maxslabsize
+//      largesize   - requests larger than this which don't fit in the current
+//                    slab are allocated directly from upstream, leaving the
+//                    current slab (and its remaining space) in place.
+//                    Requests larger than the next slab (which would need a
+//                    slab of their own) are always handled this way.
+//
+///////////////////////////////////////////////////////////////////////////////
+struct SlabOptions
 {
-public:
     constexpr static size_t defaultslabsize = 2 * 1024 * 1024;
 
-    explicit SlabMemoryResource(size_t slabsize = defaultslabsize) noexcept
-    : m_slabsize{slabsize}
+    size_t slabsize    = defaultslabsize;
+    size_t growth      = 1;
+    size_t maxslabsize = std::numeric_limits<size_t>::max();
+    size_t largesize   = std::numeric_limits<size_t>::max();
+};
+
+template<typename Statistics = NoSlabStatistics>
+class BasicSlabMemoryResource
+: public pmr::memory_resource
+, private ebo_wrapper<Statistics>
+{
+    using statistics_wrapper = ebo_wrapper<Statistics>;
+
+public:
+    using statistics_type = Statistics;
+
+    constexpr static size_t defaultslabsize = SlabOptions::defaultslabsize;
+
+    // Slabs are allocated from (and released back to) upstream, so resources
+    // can be layered, e.g., on a monotonic_buffer_resource over a stack buffer
+    // or on an MmapMemoryResource
+    explicit BasicSlabMemoryResource(SlabOptions const& options, pmr::memory_resource* upstream = pmr::new_delete_resource()) noexcept
+    : statistics_wrapper{}
+    , m_options{options}
+    , m_nextslabsize{options.slabsize}
+    , m_upstream{upstream}
+    {}
+
+    explicit BasicSlabMemoryResource(size_t slabsize = defaultslabsize, pmr::memory_resource* upstream = pmr::new_delete_resource()) noexcept
+    : BasicSlabMemoryResource{SlabOptions{slabsize}, upstream}
     {}
 
+    ~BasicSlabMemoryResource()
+    {
+        destroy(nullptr);
+        releaseSlabs(m_slabs, 0);
+        releaseSlabs(m_large, 0);
+    }
+
     // Make it moveable 
-    SlabMemoryResource(SlabMemoryResource&& that) noexcept
-    : SlabMemoryResource{that.m_slabsize}
+    BasicSlabMemoryResource(BasicSlabMemoryResource&& that) noexcept
+    : BasicSlabMemoryResource{that.m_options, that.m_upstream}
     { swap(*this, that); }
 
-    SlabMemoryResource& operator=(SlabMemoryResource&& that) noexcept
+    BasicSlabMemoryResource& operator=(BasicSlabMemoryResource&& that) noexcept
     { swap(*this, that); return *this; }
 
     // Make it swappable (since we use swap for moving)
-    friend void swap(SlabMemoryResource& l, SlabMemoryResource& r) noexcept
+    friend void swap(BasicSlabMemoryResource& l, BasicSlabMemoryResource& r) noexcept
     {
         using std::swap;
 
-        swap(l.m_free,     r.m_free);
-        swap(l.m_space,    r.m_space);
-        swap(l.m_slabsize, r.m_slabsize);
-        swap(l.m_slabs,    r.m_slabs);
+        swap(l.statistics_wrapper::ref(), r.statistics_wrapper::ref());
+        swap(l.m_free,         r.m_free);
+        swap(l.m_space,        r.m_space);
+        swap(l.m_options,      r.m_options);
+        swap(l.m_nextslabsize, r.m_nextslabsize);
+        swap(l.m_upstream,     r.m_upstream);
+        swap(l.m_used,         r.m_used);
+        swap(l.m_slabs,        r.m_slabs);
+        swap(l.m_large,        r.m_large);
+        swap(l.m_destructors,  r.m_destructors);
     }
 
     void* allocateBytes(size_t size, size_t alignment = alignof(std::max_align_t))
     {
         // Will the allocation fit in the current slab?
-        if (void* allocated = std::align(alignment, size, m_free, m_space))
-        {
-            m_free   = static_cast<uint8_t*>(m_free) + size;
-            m_space -= size;
-
+        if (void* allocated = bump(size, alignment))
             return allocated;
-        }
 
-        // Allocate and track a new slab
-        size_t   slabsize = std::max(m_slabsize, size);
-        uint8_t* slab     = m_slabs.emplace_back(std::make_unique<uint8_t[]>(slabsize)).get();
+        // Large requests don't disturb the current slab
+        if (m_options.largesize < size)
+            return allocateLarge(size, alignment);
 
-        // Are we only using part of this new slab?
-        if (size != slabsize)
-        {
-            m_free  = slab + size;
-            m_space = slabsize - size;
-        }
+        // Move on to a slab big enough for size plus any alignment padding,
+        // unless only a slab dedicated to this request (one bigger than the
+        // next slab would be) can hold it, in which case the current slab
+        // and its remaining space stay in place
+        size_t needed = alignment <= alignof(std::max_align_t) ? size : size + alignment - 1;
+        if (m_nextslabsize < needed && !hasSpareSlab(needed))
+            return allocateLarge(size, alignment);
 
-        return slab;
+        nextSlab(needed);
+        return bump(size, alignment);
     }
 
     template<typename T>
     T* allocateUninitialized(size_t n = 1, size_t alignment = alignof(T))
     { return static_cast<T*>(allocateBytes(n * sizeof(T), alignment)); }
 
+    // Deallocation is a no-op; memory is only released by rewind(), reset() or destruction
+    template<typename T>
+    void deallocateUninitialized(T* /* p */, size_t /* n */ = 1, size_t /* alignment */ = alignof(T)) noexcept {}
+
+    // Grow the allocation [p, p + size) to newsize bytes in place, which is only
+    // possible if it is the most recent allocation in the current slab and the
+    // slab has room for it.  Returns whether it was grown.
+    bool extendBytes(void* p, size_t size, size_t newsize) noexcept
+    {
+        assert(size <= newsize);
+
+        size_t more = newsize - size;
+        if (static_cast<uint8_t*>(p) + size != m_free || m_space < more)
+            return false;
+
+        statistics_wrapper::ref().allocated(more, 0);
+        m_free   = static_cast<uint8_t*>(m_free) + more;
+        m_space -= more;
+
+        return true;
+    }
+
+    // Allocate and construct a T whose destructor will be run (in reverse
+    // order of creation) by rewind(), reset() or destruction
+    // Trivially destructible types aren't tracked at all
+    template<typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        if constexpr(std::is_trivially_destructible_v<T>)
+            return ::new (allocateUninitialized<T>()) T(std::forward<Args>(args)...);
+        else
+        {
+            // Allocate the bookkeeping first, so nothing can throw after T is constructed
+            Destructor* destructor = allocateUninitialized<Destructor>();
+            T*          t          = ::new (allocateUninitialized<T>()) T(std::forward<Args>(args)...);
+
+            m_destructors = ::new (destructor) Destructor{[](void* p) noexcept { static_cast<T*>(p)->~T(); }, t, m_destructors};
+            return t;
+        }
+    }
+
+    // A checkpoint of how much has been allocated
+    class Mark
+    {
+        friend class BasicSlabMemoryResource;
+
+        size_t m_used        = 0;
+        void*  m_free        = nullptr;
+        size_t m_space       = 0;
+        size_t m_large       = 0;
+        void*  m_destructors = nullptr;
+    };
+
+    Mark mark() const noexcept
+    {
+        Mark m;
+        m.m_used        = m_used;
+        m.m_free        = m_free;
+        m.m_space       = m_space;
+        m.m_large       = m_large.size();
+        m.m_destructors = m_destructors;
+        return m;
+    }
+
+    // Destroy the objects created, and release everything allocated, since m was taken
+    // The slabs are kept for reuse by subsequent allocations,
+    // while large allocations are released back to upstream
+    void rewind(Mark const& m) noexcept
+    {
+        assert(m.m_used <= m_used);
+        assert(m.m_used < m_used || m.m_space >= m_space);
+        assert(m.m_large <= m_large.size());
+
+        destroy(static_cast<Destructor*>(m.m_destructors));
+
+        m_used  = m.m_used;
+        m_free  = m.m_free;
+        m_space = m.m_space;
+        releaseSlabs(m_large, m.m_large);
+
+        if constexpr(Statistics::enabled)
+        {
+            auto   bytes = [](size_t total, Slab const& slab) { return total + slab.size; };
+            size_t inuse = std::accumulate(m_slabs.begin(), m_slabs.begin() + m_used, size_t{0}, bytes);
+            inuse        = std::accumulate(m_large.begin(), m_large.end(), inuse, bytes);
+            statistics_wrapper::ref().rewound(inuse - m_space);
+        }
+    }
+
+    // Destroy the objects created, and release everything allocated
+    // The slabs are kept for reuse by subsequent allocations,
+    // while large allocations are released back to upstream
+    void reset() noexcept
+    { rewind(Mark{}); }
+
+    size_t slabsize() const noexcept
+    { return m_options.slabsize; }
+
+    SlabOptions const& options() const noexcept
+    { return m_options; }
+
+    pmr::memory_resource* upstream_resource() const noexcept
+    { return m_upstream; }
+
+    Statistics const& statistics() const noexcept
+    { return statistics_wrapper::ref(); }
+
 private:
     // pmr::memory_resource virtual functions
 
@@ -73,24 +340,129 @@ private:
 
     void do_deallocate(void* /* p */, size_t /* bytes */, size_t /* alignment */) override {}
 
-    bool do_is_equal(const memory_resource& /* other */) const noexcept override
-    { return true; }
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    { return this == &other; }
+
+
+    void* bump(size_t size, size_t alignment) noexcept
+    {
+        size_t space     = m_space;
+        void*  allocated = std::align(alignment, size, m_free, m_space);
+        if (allocated)
+        {
+            statistics_wrapper::ref().allocated(size, space - m_space);
+
+            m_free   = static_cast<uint8_t*>(m_free) + size;
+            m_space -= size;
+        }
+
+        return allocated;
+    }
+
+    // Is there a spare slab (left over from rewind() or reset()) of at least size bytes?
+    bool hasSpareSlab(size_t size) const noexcept
+    {
+        return std::any_of(m_slabs.begin() + m_used, m_slabs.end(),
+                           [size](Slab const& slab) { return size <= slab.size; });
+    }
+
+    // Make a slab of at least size bytes current,
+    // reusing a spare one (left over from rewind() or reset()) if possible
+    void nextSlab(size_t size)
+    {
+        auto spare = std::find_if(m_slabs.begin() + m_used, m_slabs.end(),
+                                  [size](Slab const& slab) { return size <= slab.size; });
+        bool acquired = spare == m_slabs.end();
+        if (acquired)
+        {
+            // reserve first so that push_back cannot throw and leak the slab
+            m_slabs.reserve(m_slabs.size() + 1);
+            m_slabs.push_back(acquireSlab(std::max(m_nextslabsize, size), alignof(std::max_align_t)));
+            spare = std::prev(m_slabs.end());
+
+            m_nextslabsize = std::max(m_nextslabsize, std::min(m_nextslabsize * m_options.growth, m_options.maxslabsize));
+        }
+
+        std::iter_swap(m_slabs.begin() + m_used, spare);
+
+        Slab& slab = m_slabs[m_used++];
+        statistics_wrapper::ref().nextSlab(m_space, slab.size, acquired);
+        m_free  = slab.data;
+        m_space = slab.size;
+    }
+
+    void* allocateLarge(size_t size, size_t alignment)
+    {
+        // reserve first so that push_back cannot throw and leak the allocation
+        m_large.reserve(m_large.size() + 1);
+        m_large.push_back(acquireSlab(size, alignment));
+        statistics_wrapper::ref().largeAllocated(size);
+
+        return m_large.back().data;
+    }
+
+    struct Slab
+    {
+        uint8_t* data;
+        size_t   size;
+        size_t   alignment;
+    };
+
+    Slab acquireSlab(size_t size, size_t alignment)
+    { return Slab{static_cast<uint8_t*>(m_upstream->allocate(size, alignment)), size, alignment}; }
+
+    struct Slabs : std::vector<Slab> {};
+
+    // Destructors of the objects made by create(), kept in the slabs as an intrusive list
+    struct Destructor
+    {
+        void      (*destroy)(void*) noexcept;
+        void*       object;
+        Destructor* next;
+    };
+
+    // Run the destructors of the objects created after last
+    void destroy(Destructor* last) noexcept
+    {
+        while (m_destructors != last)
+        {
+            Destructor* destructor = m_destructors;
+            m_destructors = destructor->next;
+            destructor->destroy(destructor->object);
+        }
+    }
 
+    // Release slabs[first..size()) back to upstream
+    void releaseSlabs(Slabs& slabs, size_t first) noexcept
+    {
+        for (auto slab = slabs.begin() + first; slab != slabs.end(); ++slab)
+            m_upstream->deallocate(slab->data, slab->size, slab->alignment);
 
-    struct Slabs : std::vector<std::unique_ptr<uint8_t[]>> {};
+        slabs.erase(slabs.begin() + first, slabs.end());
+    }
 
-    void*  m_free = nullptr;
-    size_t m_space = 0;
-    size_t m_slabsize;
-    Slabs  m_slabs;
+    void*                 m_free = nullptr;
+    size_t                m_space = 0;
+    SlabOptions           m_options;
+    size_t                m_nextslabsize;
+    pmr::memory_resource* m_upstream;
+    size_t                m_used = 0;
+    Slabs                 m_slabs;  // [0..m_used) in use (the last being current), [m_used..size()) spare
+    Slabs                 m_large;
+    Destructor*           m_destructors = nullptr;
 };
 
-template<typename T>
+using SlabMemoryResource = BasicSlabMemoryResource<>;
+
+// R is the slab memory resource type (SlabMemoryResource, ConcurrentSlabMemoryResource, etc.)
+// and must provide allocateUninitialized<T>(size_t) and deallocateUninitialized<T>(T*, size_t)
+template<typename T, typename R = SlabMemoryResource>
 class SlabAllocator
 {
 public:
-    constexpr static size_t defaultslabsize = SlabMemoryResource::defaultslabsize;
-    using memory_resource_pointer                = std::shared_ptr<SlabMemoryResource>;
+    constexpr static size_t defaultslabsize = R::defaultslabsize;
+    using memory_resource_type                   = R;
+    using memory_resource_pointer                = std::shared_ptr<R>;
 
     using value_type                             = T;
     using propagate_on_container_copy_assignment = std::true_type;
@@ -98,26 +470,86 @@ public:
     using propagate_on_container_swap            = std::true_type;
 
     explicit SlabAllocator(size_t slabsize = defaultslabsize)
-    : m_slabmemoryresource{std::make_shared<SlabMemoryResource>(slabsize)}
+    : m_slabmemoryresource{std::make_shared<R>(slabsize)}
     {}
 
-    SlabAllocator(SlabMemoryResource&& smr)
-    : m_slabmemoryresource{std::make_shared<SlabMemoryResource>(std::move(smr))}
+    SlabAllocator(R&& smr)
+    : m_slabmemoryresource{std::make_shared<R>(std::move(smr))}
     {}
 
-    SlabAllocator(std::shared_ptr<SlabMemoryResource> sp)
+    SlabAllocator(memory_resource_pointer sp)
     : m_slabmemoryresource{std::move(sp)}
     {}
 
     template<typename U>
-    SlabAllocator(const SlabAllocator<U>& u) noexcept
+    SlabAllocator(const SlabAllocator<U, R>& u) noexcept
+    : m_slabmemoryresource{u.get_memory_resource()}
+    {}
+
+    T* allocate(size_t n)
+    { return m_slabmemoryresource->template allocateUninitialized<T>(n); }
+
+    void deallocate(T* p, size_t n) noexcept
+    { m_slabmemoryresource->template deallocateUninitialized<T>(p, n); }
+
+    memory_resource_pointer get_memory_resource() const noexcept
+    { return m_slabmemoryresource; }
+
+private:
+    memory_resource_pointer m_slabmemoryresource;
+};
+
+template<typename L, typename R, typename MR>
+bool operator==(SlabAllocator<L, MR> const& l, SlabAllocator<R, MR> const& r) noexcept
+{ return l.get_memory_resource() == r.get_memory_resource(); }
+
+template<typename L, typename R, typename MR>
+bool operator!=(SlabAllocator<L, MR> const& l, SlabAllocator<R, MR> const& r) noexcept
+{ return !(l == r); }
+
+///////////////////////////////////////////////////////////////////////////////
+// SlabRefAllocator
+//
+//  Like SlabAllocator, but holds a raw pointer to the slab memory resource
+//  instead of a shared_ptr, so copying and rebinding (which node based
+//  containers do a lot of) is just a pointer copy with no reference counting.
+//
+//  The memory resource itself is the owner:  it must outlive every container
+//  and allocator referring to it, typically by declaring it first in the
+//  same scope (or class).
+//
+//  {
+//      cool::SlabMemoryResource smr;
+//      std::map<int, int, std::less<>, cool::SlabRefAllocator<std::pair<const int, int>>> m{smr};
+//  }
+//
+///////////////////////////////////////////////////////////////////////////////
+template<typename T, typename R = SlabMemoryResource>
+class SlabRefAllocator
+{
+public:
+    using memory_resource_type                   = R;
+    using memory_resource_pointer                = R*;
+
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+
+    SlabRefAllocator(R& smr) noexcept
+    : m_slabmemoryresource{&smr}
+    {}
+
+    template<typename U>
+    SlabRefAllocator(const SlabRefAllocator<U, R>& u) noexcept
     : m_slabmemoryresource{u.get_memory_resource()}
     {}
 
     T* allocate(size_t n)
-    { return m_slabmemoryresource->allocateUninitialized<T>(n); }
+    { return m_slabmemoryresource->template allocateUninitialized<T>(n); }
 
-    void deallocate(T* /* p */, size_t /* n */) noexcept {}
+    void deallocate(T* p, size_t n) noexcept
+    { m_slabmemoryresource->template deallocateUninitialized<T>(p, n); }
 
     memory_resource_pointer get_memory_resource() const noexcept
     { return m_slabmemoryresource; }
@@ -126,12 +558,12 @@ private:
     memory_resource_pointer m_slabmemoryresource;
 };
 
-template<typename L, typename R>
-bool operator==(SlabAllocator<L> const& l, SlabAllocator<R> const& r) noexcept
+template<typename L, typename R, typename MR>
+bool operator==(SlabRefAllocator<L, MR> const& l, SlabRefAllocator<R, MR> const& r) noexcept
 { return l.get_memory_resource() == r.get_memory_resource(); }
 
-template<typename L, typename R>
-bool operator!=(SlabAllocator<L> const& l, SlabAllocator<R> const& r) noexcept
+template<typename L, typename R, typename MR>
+bool operator!=(SlabRefAllocator<L, MR> const& l, SlabRefAllocator<R, MR> const& r) noexcept
 { return !(l == r); }
 
 } // cool namespace
@@ -0,0 +1,175 @@
+#ifndef COOL_SLABSTRING_H_
+#define COOL_SLABSTRING_H_
+
+#include <cool/SlabAllocator.h>
+#include <cool/SlabVector.h>
+#include <cstddef>
+#include <ostream>
+#include <string>       // char_traits
+#include <string_view>
+
+///////////////////////////////////////////////////////////////////////////////
+// SlabString<R>
+//
+//  A '\0'-terminated string whose buffer lives in a slab memory resource R
+//  (default SlabMemoryResource), which must outlive it.
+//
+//  Like SlabVector (which it is built on), growing first tries to extend the
+//  buffer in place, so a string built by appending while it is the most
+//  recent allocation in the slab never copies.  Appending doubles the
+//  capacity when it grows; only reserve() asks for an exact size.
+//
+//  The interface is a subset of std::string.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+template<typename R = SlabMemoryResource>
+class SlabString
+{
+    using chars_type = SlabVector<char, R>;
+
+public:
+    // types
+    using value_type             = char;
+    using traits_type            = std::char_traits<char>;
+    using memory_resource_type   = R;
+    using pointer                = char*;
+    using const_pointer          = char const*;
+    using reference              = char&;
+    using const_reference        = char const&;
+    using iterator               = pointer;
+    using const_iterator         = const_pointer;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    // construct/copy/destroy
+    explicit SlabString(R& smr) noexcept
+    : m_chars{smr}
+    {}
+
+    SlabString(std::string_view sv, R& smr)
+    : SlabString{smr}
+    { append(sv); }
+
+    R& get_memory_resource() const noexcept
+    { return m_chars.get_memory_resource(); }
+
+    // iterators
+    iterator       begin()        noexcept { return m_chars.begin(); }
+    iterator       end()          noexcept { return begin() + size(); }
+    const_iterator begin()  const noexcept { return m_chars.begin(); }
+    const_iterator end()    const noexcept { return begin() + size(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend()   const noexcept { return end(); }
+
+    // capacity
+    bool      empty()    const noexcept { return !size(); }
+    size_type size()     const noexcept { return m_chars.empty() ? 0 : m_chars.size() - sizeof('\0'); }
+    size_type length()   const noexcept { return size(); }
+    size_type capacity() const noexcept { return m_chars.capacity() ? m_chars.capacity() - sizeof('\0') : 0; }
+
+    void reserve(size_type n)
+    { m_chars.reserve(n + sizeof('\0')); }
+
+    // element access
+    reference       operator[](size_type n)       noexcept { return m_chars[n]; }
+    const_reference operator[](size_type n) const noexcept { return m_chars[n]; }
+    reference       back()                        noexcept { return m_chars[size() - 1]; }
+    const_reference back()                  const noexcept { return m_chars[size() - 1]; }
+
+    // modifiers
+    SlabString& append(std::string_view sv)
+    {
+        // sv may refer to this string, which grow() might move
+        if (begin() <= sv.data() && sv.data() <= end())
+        {
+            size_type offset = sv.data() - begin();
+            grow(size() + sv.size());
+            sv = std::string_view{begin() + offset, sv.size()};
+        }
+        else
+            grow(size() + sv.size());
+
+        unterminate();
+        m_chars.append(sv.begin(), sv.end());
+        m_chars.push_back('\0');
+
+        return *this;
+    }
+
+    SlabString& append(size_type n, char c)
+    {
+        grow(size() + n);
+
+        unterminate();
+        while (n--)
+            m_chars.push_back(c);
+        m_chars.push_back('\0');
+
+        return *this;
+    }
+
+    void push_back(char c)
+    {
+        grow(size() + 1);
+
+        unterminate();
+        m_chars.push_back(c);
+        m_chars.push_back('\0');
+    }
+
+    void pop_back() noexcept
+    {
+        m_chars.pop_back();
+        m_chars.back() = '\0';
+    }
+
+    SlabString& operator+=(std::string_view sv) { return append(sv); }
+    SlabString& operator+=(char c)              { push_back(c); return *this; }
+
+    void clear() noexcept
+    { m_chars.clear(); }
+
+    friend void swap(SlabString& l, SlabString& r) noexcept
+    { swap(l.m_chars, r.m_chars); }
+
+    // string operations
+    const_pointer c_str()            const noexcept { return m_chars.empty() ? "" : m_chars.data(); }
+    const_pointer data()             const noexcept { return c_str(); }
+    operator      std::string_view() const noexcept { return std::string_view{data(), size()}; }
+
+    // comparisons
+    friend bool operator==(SlabString const& l, SlabString const& r) noexcept
+    { return std::string_view(l) == std::string_view(r); }
+
+    friend bool operator!=(SlabString const& l, SlabString const& r) noexcept
+    { return !(l == r); }
+
+    friend bool operator<(SlabString const& l, SlabString const& r) noexcept
+    { return std::string_view(l) < std::string_view(r); }
+
+    friend std::ostream& operator<<(std::ostream& os, SlabString const& that)
+    { return os << std::string_view(that); }
+
+private:
+    // Make room for n chars plus the '\0', growing geometrically
+    void grow(size_type n)
+    { m_chars.grow(n + sizeof('\0')); }
+
+    // Remove the trailing '\0' (if any) before appending
+    void unterminate() noexcept
+    {
+        if (!m_chars.empty())
+            m_chars.pop_back();
+    }
+
+    // An empty string (even a moved from one) may have no chars at all, not even a '\0'
+    chars_type m_chars;
+};
+
+} // cool namespace
+
+#endif /* COOL_SLABSTRING_H_ */
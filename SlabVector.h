@@ -0,0 +1,317 @@
+#ifndef COOL_SLABVECTOR_H_
+#define COOL_SLABVECTOR_H_
+
+#include <cool/SlabAllocator.h>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+// SlabVector<T, R>
+//
+//  A vector whose buffer lives in a slab memory resource R (default
+//  SlabMemoryResource), which must outlive it.  R must provide
+//  allocateUninitialized<T>(size_t) and deallocateUninitialized<T>(T*, size_t)
+//  (as SlabAllocator requires).
+//
+//  std::vector<T, SlabAllocator<T>> abandons its old buffer inside the slab
+//  every time it grows, since slab deallocation is a no-op.  SlabVector
+//  instead first tries to grow its buffer in place (R::extendBytes), which
+//  succeeds whenever the buffer is the most recent allocation in the current
+//  slab, as is typical when building a vector by appending.  Only when that
+//  fails does it allocate a new buffer and move the elements over.  For an R
+//  without extendBytes (such as PooledSlabMemoryResource or
+//  ConcurrentSlabMemoryResource) it always allocates and moves.
+//
+//  Growing doubles the capacity, so only reserve() asks for an exact size.
+//  Buffers which are grown out of or destroyed are given back with
+//  deallocateUninitialized, which is a no-op for a bump resource but lets
+//  PooledSlabMemoryResource reuse them.
+//
+//  The interface is a subset of std::vector.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+
+namespace detail
+{
+    // Does R have extendBytes(void*, size_t, size_t)?
+    template<typename R, typename = void>
+    struct has_extend_bytes
+    : std::false_type {};
+
+    template<typename R>
+    struct has_extend_bytes<R, std::void_t<decltype(std::declval<R&>().extendBytes(std::declval<void*>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+} // detail namespace
+
+template<typename R>
+class SlabString;
+
+template<typename T, typename R = SlabMemoryResource>
+class SlabVector
+{
+public:
+    // types
+    using value_type             = T;
+    using memory_resource_type   = R;
+    using pointer                = T*;
+    using const_pointer          = T const*;
+    using reference              = T&;
+    using const_reference        = T const&;
+    using iterator               = pointer;
+    using const_iterator         = const_pointer;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+
+    // construct/copy/destroy
+    explicit SlabVector(R& smr) noexcept
+    : m_smr{&smr}
+    {}
+
+    SlabVector(std::initializer_list<T> il, R& smr)
+    : SlabVector{smr}
+    { append(il.begin(), il.end()); }
+
+    SlabVector(SlabVector const& that)
+    : SlabVector{*that.m_smr}
+    { append(that.begin(), that.end()); }
+
+    SlabVector(SlabVector&& that) noexcept
+    : m_smr{that.m_smr}
+    , m_data{std::exchange(that.m_data, nullptr)}
+    , m_size{std::exchange(that.m_size, 0)}
+    , m_capacity{std::exchange(that.m_capacity, 0)}
+    {}
+
+    SlabVector& operator=(SlabVector const& that)
+    {
+        if (this != &that)
+        {
+            clear();
+            append(that.begin(), that.end());
+        }
+
+        return *this;
+    }
+
+    SlabVector& operator=(SlabVector&& that) noexcept
+    { swap(*this, that); return *this; }
+
+    ~SlabVector()
+    {
+        clear();
+        m_smr->template deallocateUninitialized<T>(m_data, m_capacity);
+    }
+
+    R& get_memory_resource() const noexcept
+    { return *m_smr; }
+
+    // iterators
+    iterator               begin()         noexcept { return m_data; }
+    iterator               end()           noexcept { return m_data + m_size; }
+    const_iterator         begin()   const noexcept { return m_data; }
+    const_iterator         end()     const noexcept { return m_data + m_size; }
+    const_iterator         cbegin()  const noexcept { return begin(); }
+    const_iterator         cend()    const noexcept { return end(); }
+    reverse_iterator       rbegin()        noexcept { return reverse_iterator{end()}; }
+    reverse_iterator       rend()          noexcept { return reverse_iterator{begin()}; }
+    const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator{end()}; }
+    const_reverse_iterator rend()    const noexcept { return const_reverse_iterator{begin()}; }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend()   const noexcept { return rend(); }
+
+    // capacity
+    bool      empty()    const noexcept { return !m_size; }
+    size_type size()     const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+
+    void reserve(size_type n)
+    {
+        if (m_capacity < n)
+            reallocate(n);
+    }
+
+    void resize(size_type n)
+    {
+        reserve(n);
+        while (m_size < n)
+            emplace_back();
+        while (n < m_size)
+            pop_back();
+    }
+
+    void resize(size_type n, T const& value)
+    {
+        reserve(n);
+        while (m_size < n)
+            push_back(value);
+        while (n < m_size)
+            pop_back();
+    }
+
+    // element access
+    reference       operator[](size_type n)       noexcept { assert(n < m_size); return m_data[n]; }
+    const_reference operator[](size_type n) const noexcept { assert(n < m_size); return m_data[n]; }
+    reference       at(size_type n)                        { check(n); return m_data[n]; }
+    const_reference at(size_type n)               const    { check(n); return m_data[n]; }
+    reference       front()                       noexcept { return (*this)[0]; }
+    const_reference front()                 const noexcept { return (*this)[0]; }
+    reference       back()                        noexcept { return (*this)[m_size - 1]; }
+    const_reference back()                  const noexcept { return (*this)[m_size - 1]; }
+
+    // data access
+    T*       data()       noexcept { return m_data; }
+    T const* data() const noexcept { return m_data; }
+
+    // modifiers
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity && !extend(grownCapacity(m_size + 1)))
+        {
+            // Construct the new element before moving the old ones,
+            // as args may refer to them
+            size_type capacity = grownCapacity(m_size + 1);
+            T*        data     = m_smr->template allocateUninitialized<T>(capacity);
+            ::new (static_cast<void*>(data + m_size)) T(std::forward<Args>(args)...);
+            try
+            {
+                relocate(data, capacity);
+            }
+            catch (...)
+            {
+                data[m_size].~T();
+                throw;
+            }
+        }
+        else
+            ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+
+        return m_data[m_size++];
+    }
+
+    void push_back(T const& t) { emplace_back(t); }
+    void push_back(T&& t)      { emplace_back(std::move(t)); }
+
+    void pop_back() noexcept
+    {
+        assert(m_size);
+        m_data[--m_size].~T();
+    }
+
+    template<typename InputIterator>
+    void append(InputIterator first, InputIterator last)
+    {
+        if constexpr(std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>)
+        {
+            size_type n = static_cast<size_type>(std::distance(first, last));
+            grow(m_size + n);
+
+            std::uninitialized_copy(first, last, m_data + m_size);
+            m_size += n;
+        }
+        else
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+    }
+
+    void clear() noexcept
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    friend void swap(SlabVector& l, SlabVector& r) noexcept
+    {
+        using std::swap;
+
+        swap(l.m_smr,      r.m_smr);
+        swap(l.m_data,     r.m_data);
+        swap(l.m_size,     r.m_size);
+        swap(l.m_capacity, r.m_capacity);
+    }
+
+    // comparisons
+    friend bool operator==(SlabVector const& l, SlabVector const& r)
+    { return std::equal(l.begin(), l.end(), r.begin(), r.end()); }
+
+    friend bool operator!=(SlabVector const& l, SlabVector const& r)
+    { return !(l == r); }
+
+private:
+    // SlabString grows its chars (making room for the '\0' as well) through grow()
+    friend class SlabString<R>;
+
+    void check(size_type n) const
+    {
+        if (m_size <= n)
+            throw std::out_of_range("SlabVector");
+    }
+
+    // Double the capacity, but at least enough to hold n
+    size_type grownCapacity(size_type n) const noexcept
+    { return std::max(n, 2 * m_capacity); }
+
+    // Make room for n elements, growing geometrically
+    void grow(size_type n)
+    {
+        if (m_capacity < n)
+            reallocate(grownCapacity(n));
+    }
+
+    // Try growing the buffer in place
+    bool extend(size_type capacity) noexcept
+    {
+        if constexpr(detail::has_extend_bytes<R>::value)
+        {
+            if (!m_data || !m_smr->extendBytes(m_data, m_capacity * sizeof(T), capacity * sizeof(T)))
+                return false;
+
+            m_capacity = capacity;
+            return true;
+        }
+        else
+            return false;
+    }
+
+    void reallocate(size_type capacity)
+    {
+        if (!extend(capacity))
+            relocate(m_smr->template allocateUninitialized<T>(capacity), capacity);
+    }
+
+    // Move the elements to the new buffer data and make it current
+    void relocate(T* data, size_type capacity)
+    {
+        std::uninitialized_move(begin(), end(), data);
+        std::destroy(begin(), end());
+        m_smr->template deallocateUninitialized<T>(m_data, m_capacity);
+
+        m_data     = data;
+        m_capacity = capacity;
+    }
+
+    R*        m_smr;
+    T*        m_data     = nullptr;
+    size_type m_size     = 0;
+    size_type m_capacity = 0;
+};
+
+} // cool namespace
+
+#endif /* COOL_SLABVECTOR_H_ */
@@ -0,0 +1,266 @@
+#ifndef COOL_TEXTBUILDER_H_
+#define COOL_TEXTBUILDER_H_
+
+#include <cool/CChar.h>
+#include <cool/ratio.h>
+#include <cool/default_init_allocator.h>
+#include <cool/to_cstring.h>
+#include <cool/to_cstrings.h>
+#include <cool/uuid_chars.h>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <algorithm>    // copy_n, max, min
+#include <charconv>     // to_chars
+#include <chrono>
+#include <cstddef>      // size_t
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// TextBuilder
+//
+//  Builds text (such as a log line) by appending pieces directly into one
+//  buffer, without allocating per piece, locales or virtual calls.
+//
+//  FixedTextBuilder<N>
+//      holds at most N chars in an (uninitialized) array, so it can live on
+//      the stack and never allocates.  Appending past N truncates and sets
+//      truncated().
+//
+//  TextBuilder<A = default_init_allocator<char>>
+//      grows as needed, in a vector<char, A>;  the default_init_allocator
+//      means growing doesn't zero the chars which are about to be written.
+//
+//  Both are BasicTextBuilder<Buffer>, where append(t) (or << t) takes:
+//
+//      std::string_view (and so const char*, std::string, c_str_t, ...)
+//      char                        - the char itself
+//      integral types              - in base 10, formatted in place
+//      float, double               - as to_cstring formats them (shortest)
+//      CChar                       - the (possibly escaped) char
+//      to_cstring<...>             - any to_cstring specialization
+//      boost::uuids::uuid          - the 36 char form, formatted in place
+//      std::chrono::duration       - the count and unit, such as "2 hours"
+//                                    or "5 milliseconds" (the same text
+//                                    cool::chrono::duration::operator<<
+//                                    produces on a default ostream, so a
+//                                    floating point count is like printf
+//                                    %g, not shortest as for a double)
+//
+//  bool is deliberately not accepted, so that it doesn't sneak in as a char.
+//
+//  The result is available as view() (or string_view, data() and size()),
+//  so it can be written straight out, as in
+//      ::write(fd, builder.data(), builder.size());
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+    namespace detail
+    {
+        // Storage for FixedTextBuilder
+        template<size_t N>
+        class fixed_text_buffer
+        {
+        public:
+            static constexpr size_t max_capacity{N};
+
+            char*       data()           noexcept { return m_chars; }
+            char const* data()     const noexcept { return m_chars; }
+            size_t      size()     const noexcept { return m_size; }
+            size_t      capacity() const noexcept { return N; }
+
+            // Makes room for (up to) n more chars, returning how many fit
+            size_t room(size_t n) noexcept
+            { return std::min(n, N - m_size); }
+
+            void commit(char const* end) noexcept
+            { m_size = static_cast<size_t>(end - m_chars); }
+
+        private:
+            size_t m_size = 0;
+            char   m_chars[N];
+        };
+
+        // Storage for TextBuilder; the chars past size() (up to
+        // m_chars.size()) are room which has already been allocated
+        template<typename A>
+        class growable_text_buffer
+        {
+        public:
+            static constexpr size_t max_capacity{~size_t{}};
+
+            char*       data()           noexcept { return m_chars.data(); }
+            char const* data()     const noexcept { return m_chars.data(); }
+            size_t      size()     const noexcept { return m_size; }
+            size_t      capacity() const noexcept { return m_chars.size(); }
+
+            // Makes room for n more chars (at least doubling when it grows, and
+            // default initializing them, which for default_init_allocator is
+            // a no-op), returning n
+            size_t room(size_t n)
+            {
+                if (m_chars.size() - m_size < n)
+                    m_chars.resize(std::max(m_size + n, 2 * m_chars.size()));
+
+                return n;
+            }
+
+            void commit(char const* end) noexcept
+            { m_size = static_cast<size_t>(end - m_chars.data()); }
+
+        private:
+            std::vector<char, A> m_chars;
+            size_t               m_size = 0;
+        };
+
+    } // detail namespace
+
+    template<typename Buffer>
+    class BasicTextBuilder
+    {
+    public:
+        using value_type      = char;
+        using const_pointer   = char const*;
+        using const_iterator  = const_pointer;
+        using size_type       = std::size_t;
+
+        // appending
+        BasicTextBuilder& append(std::string_view s) noexcept(noexcept(std::declval<Buffer&>().room(0)))
+        {
+            size_type n{m_buffer.room(s.size())};
+            m_truncated |= n != s.size();
+            m_buffer.commit(std::copy_n(s.data(), n, last()));
+            return *this;
+        }
+
+        template<typename C, typename = std::enable_if_t<std::is_same_v<C, char>>>
+        BasicTextBuilder& append(C c)
+        { return append(std::string_view{&c, 1}); }
+
+        template<typename I, typename = std::enable_if_t<detail::is_to_cstring_integral_v<I>
+                                                         && !std::is_same_v<I, char>
+                                                         && !std::is_same_v<I, bool>>, typename = void>
+        BasicTextBuilder& append(I i)
+        { return format<detail::max_chars<I, 10>()>([i](char* out) { return to_cstrings(i, out); }); }
+
+#if defined(__cpp_lib_to_chars)
+        template<typename F, typename = std::enable_if_t<std::is_same_v<F, float> || std::is_same_v<F, double>>,
+                 typename = void, typename = void>
+        BasicTextBuilder& append(F f)
+        {
+            constexpr size_type max_size{to_cstring<F, chars_format_constant<shortest_chars_format>>::max_size()};
+            return format<max_size>([f](char* out) { return std::to_chars(out, out + max_size, f).ptr; });
+        }
+#endif
+
+        BasicTextBuilder& append(CChar const& c)
+        { return append(std::string_view{c.c_str()}); }
+
+        template<typename... Ts>
+        BasicTextBuilder& append(to_cstring<Ts...> const& s)
+        {
+            if constexpr(std::is_convertible_v<to_cstring<Ts...> const&, std::string_view>)
+                return append(std::string_view{s});
+            else
+                return append(std::string_view{std::move(s).c_str()});
+        }
+
+        BasicTextBuilder& append(boost::uuids::uuid const& id)
+        { return format<detail::uuid_chars>([&id](char* out) { return detail::format_uuid(id.begin(), out); }); }
+
+        template<typename Rep, typename Period>
+        BasicTextBuilder& append(std::chrono::duration<Rep, Period> d)
+        {
+            if constexpr(std::is_floating_point_v<Rep>)
+                appendGeneral(d.count()).append(' ');
+            else
+                append(d.count()).append(' ');
+
+            if constexpr(3600 == Period::num && 1 == Period::den)
+                return append("hours");
+            else if constexpr(60 == Period::num && 1 == Period::den)
+                return append("minutes");
+            else if constexpr(1 == Period::num && 1 == Period::den)
+                return append("seconds");
+            else if constexpr(ratio::detail::prefix(Period::num, Period::den).empty())
+                return append("ratio<").append(Period::num).append(',').append(Period::den).append(">seconds");
+            else
+                return append(ratio::detail::prefix(Period::num, Period::den)).append("seconds");
+        }
+
+        template<typename T>
+        BasicTextBuilder& operator<<(T const& t)
+        { return append(t); }
+
+        void clear() noexcept
+        {
+            m_buffer.commit(m_buffer.data());
+            m_truncated = false;
+        }
+
+        // capacity
+        size_type size()      const noexcept { return m_buffer.size(); }
+        size_type length()    const noexcept { return size(); }
+        size_type capacity()  const noexcept { return m_buffer.capacity(); }
+        bool      empty()     const noexcept { return !size(); }
+
+        // true if a FixedTextBuilder ran out of room
+        bool      truncated() const noexcept { return m_truncated; }
+
+        // access
+        const_iterator   begin() const noexcept { return m_buffer.data(); }
+        const_iterator   end()   const noexcept { return m_buffer.data() + size(); }
+        const_pointer    data()  const noexcept { return m_buffer.data(); }
+        std::string_view view()  const noexcept { return std::string_view{data(), size()}; }
+        operator std::string_view() const noexcept { return view(); }
+
+    private:
+        char* last() noexcept { return m_buffer.data() + size(); }
+
+#if defined(__cpp_lib_to_chars)
+        // Formats f as an ostream with the default flags and precision (6)
+        // does, which is printf %g
+        template<typename F>
+        BasicTextBuilder& appendGeneral(F f)
+        {
+            constexpr size_type max_size{32};
+            return format<max_size>([f](char* out) { return std::to_chars(out, out + max_size, f, std::chars_format::general, 6).ptr; });
+        }
+#endif
+
+        // Formats in place with format(out) -> end when there is room for
+        // MaxChars; otherwise (only when fixed) formats aside and truncates
+        template<size_type MaxChars, typename Format>
+        BasicTextBuilder& format(Format format)
+        {
+            if constexpr(MaxChars <= Buffer::max_capacity)
+            {
+                if (MaxChars == m_buffer.room(MaxChars))
+                {
+                    m_buffer.commit(format(last()));
+                    return *this;
+                }
+            }
+
+            char chars[MaxChars];
+            return append(std::string_view{chars, static_cast<size_type>(format(chars) - chars)});
+        }
+
+        Buffer m_buffer;
+        bool   m_truncated = false;
+    };
+
+    template<size_t N>
+    using FixedTextBuilder = BasicTextBuilder<detail::fixed_text_buffer<N>>;
+
+    template<typename A = default_init_allocator<char>>
+    using TextBuilder = BasicTextBuilder<detail::growable_text_buffer<A>>;
+
+} // cool namespace
+
+#endif /* COOL_TEXTBUILDER_H_ */
@@ -0,0 +1,169 @@
+#ifndef COOL_ALIGNED_ALLOCATOR_H_
+#define COOL_ALIGNED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <cool/ebo_allocator.h>
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// aligned_allocator<T, Alignment, A, Padded>
+//
+//  An allocator whose allocations are aligned to (at least) Alignment bytes,
+//  such as for SIMD loads or to put a buffer on its own cache lines.
+//
+//  It allocates bytes (A rebound to unsigned char) from the underlying
+//  allocator, enough to align the result, and stores the offset back to the
+//  underlying allocation just before the aligned pointer, so it works with
+//  any underlying allocator, whether or not it supports over-alignment.
+//
+//  If Padded, the underlying allocation also extends to the next multiple
+//  of Alignment past the end of the buffer, so that nothing else shares its
+//  last cache line (no false sharing).
+//
+//  It composes with the other allocator adaptors, as in
+//  default_init_allocator<T, aligned_allocator<T, 64>>, and rebind keeps
+//  Alignment and Padded.
+//
+// Template parameters:
+//  T         - the value_type for the allocations
+//  Alignment - the alignment, a power of 2 no smaller than alignof(T)
+//              (defaults to cache_line_size)
+//  A         - the underlying allocator (defaults to std::allocator<T>)
+//  Padded    - whether to pad allocations to a multiple of Alignment
+//              (defaults to false)
+//
+///////////////////////////////////////////////////////////////////////////////
+//
+// aligned_vector<T, Alignment, A, Padded>
+//
+//  An alias template for std::vector which uses aligned_allocator.
+//
+///////////////////////////////////////////////////////////////////////////////
+namespace cool
+{
+    inline constexpr size_t cache_line_size = 64;
+
+    template<typename T, size_t Alignment = cache_line_size, typename A = std::allocator<T>, bool Padded = false>
+    class aligned_allocator
+    : private ebo_allocator<A>
+    {
+        static_assert(Alignment && !(Alignment & (Alignment - 1)), "Alignment must be a power of 2");
+        static_assert(alignof(T) <= Alignment, "Alignment must be at least alignof(T)");
+        static_assert(std::is_same_v<typename std::allocator_traits<A>::pointer, T*>, "A must use raw pointers");
+
+        using ebo_alloc    = ebo_allocator<A>;
+        using byte_alloc   = typename std::allocator_traits<A>::template rebind_alloc<unsigned char>;
+        using byte_traits  = std::allocator_traits<byte_alloc>;
+        using offset_type  = size_t;
+
+    public:
+        using typename ebo_alloc::inner_allocator_type;
+        using          ebo_alloc::inner_allocator;
+
+        using value_type         = T;
+        using pointer            = T*;
+        using const_pointer      = T const*;
+        using void_pointer       = void*;
+        using const_void_pointer = void const*;
+        using typename ebo_alloc::size_type;
+        using typename ebo_alloc::difference_type;
+        using typename ebo_alloc::propagate_on_container_copy_assignment;
+        using typename ebo_alloc::propagate_on_container_move_assignment;
+        using typename ebo_alloc::propagate_on_container_swap;
+        using typename ebo_alloc::is_always_equal;
+
+        constexpr static size_t alignment = Alignment;
+        constexpr static bool   padded    = Padded;
+
+        template<typename U>
+        struct rebind { using other = aligned_allocator<U, Alignment, typename std::allocator_traits<A>::template rebind_alloc<U>, Padded>; };
+
+        constexpr aligned_allocator() = default;
+
+        template<typename TT, typename AA>
+        constexpr aligned_allocator(aligned_allocator<TT, Alignment, AA, Padded> const& that) noexcept
+        : ebo_alloc(that.inner_allocator())
+        {}
+
+        template<typename TT, typename AA>
+        constexpr aligned_allocator(aligned_allocator<TT, Alignment, AA, Padded>&& that) noexcept
+        : ebo_alloc(std::move(that.inner_allocator()))
+        {}
+
+        template<typename... Us, typename = std::enable_if_t<std::is_constructible_v<A, Us...>>>
+        constexpr aligned_allocator(Us&&... us)
+        noexcept(noexcept(A(std::forward<Us>(us)...)))
+        : ebo_alloc(std::forward<Us>(us)...)
+        {}
+
+        T* allocate(size_type n)
+        {
+            if (max_size() < n)
+                throw std::bad_array_new_length{};
+
+            byte_alloc     bytes(inner_allocator());
+            size_t         size = allocationSize(n);
+            unsigned char* raw  = byte_traits::allocate(bytes, size);
+
+            // Leave room for the offset, then round up to Alignment
+            uintptr_t   address = reinterpret_cast<uintptr_t>(raw) + sizeof(offset_type);
+            offset_type offset  = ((address + Alignment - 1) & ~uintptr_t(Alignment - 1)) - reinterpret_cast<uintptr_t>(raw);
+            std::memcpy(raw + offset - sizeof(offset_type), &offset, sizeof(offset_type));
+
+            return reinterpret_cast<T*>(raw + offset);
+        }
+
+        void deallocate(T* p, size_type n) noexcept
+        {
+            unsigned char* aligned = reinterpret_cast<unsigned char*>(p);
+            offset_type    offset;
+            std::memcpy(&offset, aligned - sizeof(offset_type), sizeof(offset_type));
+
+            byte_alloc bytes(inner_allocator());
+            byte_traits::deallocate(bytes, aligned - offset, allocationSize(n));
+        }
+
+        size_type max_size() const noexcept
+        { return (std::numeric_limits<size_type>::max() - sizeof(offset_type) - 2 * Alignment) / sizeof(T); }
+
+        using ebo_alloc::construct;
+        using ebo_alloc::destroy;
+
+        aligned_allocator select_on_container_copy_construction() const
+        { return aligned_allocator(std::allocator_traits<A>::select_on_container_copy_construction(inner_allocator())); }
+
+    private:
+        // Underlying bytes needed for n aligned Ts (plus the offset and any padding)
+        constexpr static size_t allocationSize(size_type n) noexcept
+        {
+            size_t size = n * sizeof(T);
+            if constexpr(Padded)
+                size = (size + Alignment - 1) & ~(Alignment - 1);
+
+            return sizeof(offset_type) + Alignment - 1 + size;
+        }
+    };
+
+    template<typename LT, size_t LN, typename LA, bool LP, typename RT, size_t RN, typename RA, bool RP>
+    constexpr bool operator==(aligned_allocator<LT, LN, LA, LP> const& l, aligned_allocator<RT, RN, RA, RP> const& r) noexcept
+    { return LN == RN && LP == RP && l.inner_allocator() == r.inner_allocator(); }
+
+    template<typename LT, size_t LN, typename LA, bool LP, typename RT, size_t RN, typename RA, bool RP>
+    constexpr bool operator!=(aligned_allocator<LT, LN, LA, LP> const& l, aligned_allocator<RT, RN, RA, RP> const& r) noexcept
+    { return !(l == r); }
+
+
+    template<typename T, size_t Alignment = cache_line_size, typename A = std::allocator<T>, bool Padded = false>
+    using aligned_vector = std::vector<T, aligned_allocator<T, Alignment, A, Padded>>;
+
+
+} // cool namespace
+
+#endif /* COOL_ALIGNED_ALLOCATOR_H_ */
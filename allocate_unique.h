@@ -0,0 +1,208 @@
+#ifndef COOL_ALLOCATE_UNIQUE_H_
+#define COOL_ALLOCATE_UNIQUE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+// allocate_unique<T>
+//
+//  allocate_unique is to make_unique as allocate_shared is to make_shared:
+//  the memory comes from an allocator (such as SlabAllocator), which is
+//  rebound to the element type and stored in the deleter.
+//
+//  allocator_delete<T, A>
+//      a unique_ptr deleter which destroys and deallocates through A
+//      (allocator_delete<T[], A> also holds the size)
+//
+//  unique_ptr<T, allocator_delete<T, A>> allocate_unique<T>(a, args...)
+//      T(args...)
+//
+//  unique_ptr<T[], allocator_delete<T[], A>> allocate_unique<T[]>(a, n)
+//      value-initialized array of T of size n
+//
+//  unique_ptr<T, allocator_delete<T, A>> allocate_unique_for_overwrite<T>(a)
+//      default-initialized T
+//
+//  unique_ptr<T[], allocator_delete<T[], A>> allocate_unique_for_overwrite<T[]>(a, n)
+//      default-initialized array of T of size n
+//
+//  As with make_unique, T[N] is not supported.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cool/ebo_wrapper.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cool
+{
+    template<typename T, typename A = std::allocator<std::remove_extent_t<T>>>
+    class allocator_delete
+    : private ebo_wrapper<typename std::allocator_traits<A>::template rebind_alloc<T>>
+    {
+        using wrapper = ebo_wrapper<typename std::allocator_traits<A>::template rebind_alloc<T>>;
+        using traits  = std::allocator_traits<typename wrapper::value_type>;
+
+    public:
+        using allocator_type = typename wrapper::value_type;
+        using pointer        = typename traits::pointer;
+
+        explicit allocator_delete(A const& a) noexcept
+        : wrapper(a)
+        {}
+
+        allocator_type get_allocator() const noexcept
+        { return wrapper::ref(); }
+
+        void operator()(pointer p) noexcept
+        {
+            traits::destroy(wrapper::ref(), std::addressof(*p));
+            traits::deallocate(wrapper::ref(), p, 1);
+        }
+    };
+
+    template<typename T, typename A>
+    class allocator_delete<T[], A>
+    : private ebo_wrapper<typename std::allocator_traits<A>::template rebind_alloc<T>>
+    {
+        using wrapper = ebo_wrapper<typename std::allocator_traits<A>::template rebind_alloc<T>>;
+        using traits  = std::allocator_traits<typename wrapper::value_type>;
+
+    public:
+        using allocator_type = typename wrapper::value_type;
+        using pointer        = typename traits::pointer;
+
+        allocator_delete(A const& a, size_t n) noexcept
+        : wrapper(a)
+        , m_size{n}
+        {}
+
+        allocator_type get_allocator() const noexcept
+        { return wrapper::ref(); }
+
+        size_t size() const noexcept
+        { return m_size; }
+
+        void operator()(pointer p) noexcept
+        {
+            for (size_t n = m_size; n--; )
+                traits::destroy(wrapper::ref(), std::addressof(p[n]));
+            traits::deallocate(wrapper::ref(), p, m_size);
+        }
+
+    private:
+        size_t m_size;
+    };
+
+    namespace detail
+    {
+        // allocate_unique_if are helpers for allocate_unique
+        template<typename T, typename A>
+        struct allocate_unique_if
+        { using single_object = std::unique_ptr<T, allocator_delete<T, A>>; };
+
+        template<typename T, typename A>
+        struct allocate_unique_if<T[], A>
+        { using array = std::unique_ptr<T[], allocator_delete<T[], A>>; };
+
+        template<typename T, size_t N, typename A>
+        struct allocate_unique_if<T[N], A>
+        { using bound = void; };
+
+        // Allocate n Ts and construct each with construct(a, p),
+        // destroying any already constructed if one throws
+        template<typename T, typename A, typename Construct>
+        typename std::allocator_traits<A>::pointer
+        allocate_constructed(A& a, size_t n, Construct construct)
+        {
+            using traits = std::allocator_traits<A>;
+
+            typename traits::pointer p = traits::allocate(a, n);
+            size_t                   constructed = 0;
+            try
+            {
+                for (; constructed != n; ++constructed)
+                    construct(a, std::addressof(p[constructed]));
+            }
+            catch (...)
+            {
+                while (constructed--)
+                    traits::destroy(a, std::addressof(p[constructed]));
+                traits::deallocate(a, p, n);
+                throw;
+            }
+
+            return p;
+        }
+
+        template<typename T, typename A>
+        using rebind_alloc = typename std::allocator_traits<A>::template rebind_alloc<T>;
+
+    } // detail namespace
+
+    // unique_ptr<T, allocator_delete<T, A>> allocate_unique<T>(a, args...)
+    template<typename T, typename A, typename... Args>
+    typename detail::allocate_unique_if<T, A>::single_object
+    allocate_unique(A const& a, Args&&... args)
+    {
+        detail::rebind_alloc<T, A> alloc(a);
+        auto p = detail::allocate_constructed<T>(alloc, 1, [&](auto& al, T* t)
+        { std::allocator_traits<detail::rebind_alloc<T, A>>::construct(al, t, std::forward<Args>(args)...); });
+
+        return typename detail::allocate_unique_if<T, A>::single_object(p, allocator_delete<T, A>(a));
+    }
+
+    // unique_ptr<T[], allocator_delete<T[], A>> allocate_unique<T[]>(a, n)
+    template<typename T, typename A>
+    typename detail::allocate_unique_if<T, A>::array
+    allocate_unique(A const& a, size_t n)
+    {
+        using U = std::remove_extent_t<T>;
+
+        detail::rebind_alloc<U, A> alloc(a);
+        auto p = detail::allocate_constructed<U>(alloc, n, [](auto& al, U* u)
+        { std::allocator_traits<detail::rebind_alloc<U, A>>::construct(al, u); });
+
+        return typename detail::allocate_unique_if<T, A>::array(p, allocator_delete<T, A>(a, n));
+    }
+
+    // unique_ptr<T, allocator_delete<T, A>> allocate_unique_for_overwrite<T>(a)
+    template<typename T, typename A>
+    typename detail::allocate_unique_if<T, A>::single_object
+    allocate_unique_for_overwrite(A const& a)
+    {
+        detail::rebind_alloc<T, A> alloc(a);
+        auto p = detail::allocate_constructed<T>(alloc, 1, [](auto&, T* t)
+        { ::new (static_cast<void*>(t)) T; });
+
+        return typename detail::allocate_unique_if<T, A>::single_object(p, allocator_delete<T, A>(a));
+    }
+
+    // unique_ptr<T[], allocator_delete<T[], A>> allocate_unique_for_overwrite<T[]>(a, n)
+    template<typename T, typename A>
+    typename detail::allocate_unique_if<T, A>::array
+    allocate_unique_for_overwrite(A const& a, size_t n)
+    {
+        using U = std::remove_extent_t<T>;
+
+        detail::rebind_alloc<U, A> alloc(a);
+        auto p = detail::allocate_constructed<U>(alloc, n, [](auto&, U* u)
+        { ::new (static_cast<void*>(u)) U; });
+
+        return typename detail::allocate_unique_if<T, A>::array(p, allocator_delete<T, A>(a, n));
+    }
+
+    // allocate_unique<T[n]>(a, Args&&...)
+    template<typename T, typename A, typename... Args>
+    typename detail::allocate_unique_if<T, A>::bound
+    allocate_unique(A const&, Args&&...) = delete;
+
+    // allocate_unique_for_overwrite<T[n]>(a, Args&&...)
+    template<typename T, typename A, typename... Args>
+    typename detail::allocate_unique_if<T, A>::bound
+    allocate_unique_for_overwrite(A const&, Args&&...) = delete;
+
+} // cool namespace
+
+#endif /* COOL_ALLOCATE_UNIQUE_H_ */
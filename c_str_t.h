@@ -1,60 +1,96 @@
 #ifndef COOL_C_STR_T_H_
 #define COOL_C_STR_T_H_
 
+#include <cool/to_cstring_core.h>
+
+#include <algorithm>    // max
 #include <array>
 #include <cassert>
-#include <climits>      // CHAR_BIT
 #include <cstddef>      // size_t
+#include <cstdint>      // uint_least8_t
 #include <limits>       // numeric_limits
 #include <string_view>
-#include <type_traits>  // make_unsigned
+#include <type_traits>
 
 namespace cool
 {
     ///////////////////////////////////////////////////////////////////////////
-    // c_str_t
+    // c_str_t<I, Base>
     //
     //  c_str_t is a non-allocating owning string (with no throwing operations)
     //  which holds an integral value converted to a character string.
     //
-    //  Requires that base has a value between 2 and 36 (inclusive).
+    //  Requires that base has a value between Base and 36 (inclusive).
+    //  Base is the smallest base the buffer has room for, and defaults to
+    //  2, so c_str_t<I> takes any base.  Only a debug build checks; otherwise
+    //  a base outside of that results in an empty string, rather than
+    //  overflowing the buffer.
     //
     //  On construction, the value is converted to a string of digits in the
     //  given base (with no redundant leading zeroes).  Digits in the range
     //  10..35 (inclusive) are represented as lowercase characters a..z.  If
     //  the value is less than zero, the representation starts with '-'.
     //
+    //  The conversion is the one to_cstring uses (see to_cstring_core.h):
+    //  when base is Base, 10, 16, 8 or 2, the digits are generated by code
+    //  specialized for that base.  The buffer holds exactly the most chars
+    //  an I can take in Base, and the only other member is a one byte
+    //  position, so c_str_t<int, 10> is 13 bytes.  Everything is constexpr,
+    //  so a constexpr c_str_t is formatted entirely at compile time.
+    //
+    //  base defaults to 10 (or Base, if that is larger).  c_str_t(value) is
+    //  deduced as c_str_t<I, 10>, sized for base 10, and c_str_t(value, base)
+    //  as c_str_t<I> (so that it can hold any base).
+    //
     //  One example of using this is printf("%s\n", c_str_t(value).c_str());
     //  * It doesn't use locales, so it may be faster.
     //  * Like streams, you don't have to know the exact type of value passed
     //    to it, as templates take care of that.
     //
     ///////////////////////////////////////////////////////////////////////////
-    template<typename I>
+    template<typename I, int Base = 2>
     class c_str_t
     {
+        static_assert(detail::is_to_cstring_integral_v<I>);
+        static_assert(2 <= Base && Base <= 36);
+
     public:
         using size_type = std::size_t;
-    
-        explicit constexpr c_str_t(I i, int base = 10) noexcept
-        : m_pos{max_size()}
-        , m_base{static_cast<unsigned_t>(base)}
-        , m_i{i}
-        {
-            assert(2 <= base && base <= 36);
 
-            bool       negative{i < I{}};
-            unsigned_t u{negative ? -i : i};
+        static const constexpr int min_base = Base;
 
-            m_c_str_array[m_pos] = '\0';
-            do
-            {
-                m_c_str_array[--m_pos] = "0123456789abcdefghijklmnopqrstuvwxyz"[u % m_base];
-                u /= m_base;
-            } while (u);
-
-            if (negative)
-                m_c_str_array[--m_pos] = '-';
+        // A constant expression has to initialize the whole buffer, but
+        // at run time (when that can be told apart) only the chars
+        // actually formatted are written
+        explicit constexpr c_str_t(I i, int base = std::max(Base, 10)) noexcept
+#if !(defined(__cpp_lib_is_constant_evaluated) && 201907L <= __cpp_constexpr)
+        : m_c_str_array{}
+#endif
+        {
+#if defined(__cpp_lib_is_constant_evaluated) && 201907L <= __cpp_constexpr
+            if (std::is_constant_evaluated())
+                m_c_str_array = c_str_array_t{};
+#endif
+
+            using magnitude_type = detail::magnitude_t<I>;
+
+            char* last = m_c_str_array.data() + max_size();
+            *last      = '\0';
+            m_pos      = static_cast<pos_type>(max_size());
+
+            // The digits might not fit, so leave it empty
+            assert(Base <= base && base <= 36);
+            if (base < Base || 36 < base)
+                return;
+
+            // Base 10 is the usual case, even when the buffer is sized for base 2
+            char* first = base == Base ? detail::format_backward<Base>(last, detail::magnitude(i))
+                        : base == 10   ? detail::format_backward<10>(last, detail::magnitude(i))
+                                       : detail::format_backward(last, detail::magnitude(i), magnitude_type(base));
+            if (i < I{})
+                *--first = '-';
+
+            m_pos = static_cast<pos_type>(first - m_c_str_array.data());
         }
 
         // capacity
@@ -65,7 +101,7 @@ namespace cool
         { return size(); }
 
         static constexpr size_type max_size() noexcept
-        { return std::numeric_limits<I>::is_signed + CHAR_BIT * sizeof(I); }
+        { return detail::max_chars<I, Base>(); }
 
         // string operations
         constexpr const char* c_str() const noexcept
@@ -79,18 +115,21 @@ namespace cool
 
     private:
         using c_str_array_t = std::array<char, max_size() + sizeof('\0')>;
-        using unsigned_t = std::make_unsigned_t<I>;
+        using pos_type      = std::uint_least8_t;
+        static_assert(max_size() <= std::numeric_limits<pos_type>::max());
 
         c_str_array_t m_c_str_array;
-        size_type     m_pos;
-        unsigned_t    m_base;
-        I             m_i;
+        pos_type      m_pos = 0;
     };
 
+    // Single parameter constructor assumes base 10
+    template<typename I>
+    c_str_t(I) -> c_str_t<I, 10>;
+
+    // Two parameter constructor uses the one that can hold the largest magnitude, which is base 2
     template<typename I>
     c_str_t(I, int) -> c_str_t<I>;
 
 }  // cool namespace
 
 #endif /* COOL_C_STR_T_H */
-
@@ -0,0 +1,242 @@
+#ifndef COOL_FROM_CSTRING_H_
+#define COOL_FROM_CSTRING_H_
+
+#include <cool/to_cstring_core.h>
+#include <cool/uuid_chars.h>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <cassert>
+#include <cstddef>      // size_t
+#include <cstdint>      // uint8_t
+#include <string_view>
+#include <system_error> // errc
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////
+// from_cstring<T, Base>
+//
+//  from_cstring is the parsing counterpart of to_cstring:  it converts the
+//  start of a string_view back to a T, without allocating, locales, errno
+//  or exceptions.
+//
+//  from_cstring_result<T> from_cstring<I, Base = 10>(sv, base = Base)
+//      I is an integral type (including __int128_t and __uint128_t) and
+//      base is between 2 and 36 (inclusive).  Parses an optional '-' (only
+//      if I is signed) followed by as many digits in base as possible, where
+//      the digits 10..35 are a..z (or A..Z).  Like to_cstring, when base is
+//      the compile time Base, faster code is used.
+//
+//  from_cstring_result<boost::uuids::uuid> from_cstring<boost::uuids::uuid>(sv)
+//      parses the 36 char form (8-4-4-4-12 hex digits, either case)
+//      which to_cstring<boost::uuids::uuid> produces.
+//
+//  from_cstring_result<T> has:
+//      value - the parsed value (T{} on error)
+//      end   - the position in sv just past what was parsed (0 if nothing
+//              could be parsed; for overflow, past all the digits)
+//      ec    - errc{} on success, errc::invalid_argument if nothing could be
+//              parsed or errc::result_out_of_range on overflow
+//  and is true (explicit operator bool) on success.
+//
+//  from_cstring_result<size_t> from_cstrings<T, Base = 10>(sv, first, last, separator = ',', base = Base)
+//      is the counterpart of to_cstrings:  parses up to last - first Ts
+//      (each as from_cstring does), separated by separator, into [first, last).
+//      value is how many were parsed, and end is just past the last one.
+//      Stopping early because sv doesn't continue with separator is not an
+//      error; a T which fails to parse is, with its ec.
+//
+//  For any value v, from_cstring<I, Base>(to_cstring<I, Base>(v)).value == v.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+    template<typename T>
+    struct from_cstring_result
+    {
+        T         value;
+        size_t    end;
+        std::errc ec;
+
+        constexpr explicit operator bool() const noexcept
+        { return std::errc{} == ec; }
+    };
+
+    namespace detail
+    {
+        // digit_values[c] is the value of c as a digit (either case), or 36 if it isn't one
+        struct digit_values
+        {
+            constexpr digit_values() noexcept
+            : values{}
+            {
+                for (auto& value : values)
+                    value = 36;
+
+                for (uint8_t d = 0; d != 36; ++d)
+                {
+                    char c = digit_chars[d];
+                    values[static_cast<unsigned char>(c)] = d;
+                    if ('a' <= c && c <= 'z')
+                        values[static_cast<unsigned char>(c - 'a' + 'A')] = d;
+                }
+            }
+
+            constexpr uint8_t operator[](char c) const noexcept
+            { return values[static_cast<unsigned char>(c)]; }
+
+            uint8_t values[256];
+        };
+
+        inline constexpr digit_values digit_values_v{};
+
+        // Set in the count returned by parse_digits on overflow
+        inline constexpr size_t parse_overflow{~(~size_t{} >> 1)};
+
+        // Parses the digits at the start of s into u (which must start as 0),
+        // returning how many digits there were (| parse_overflow if past limit)
+        template<typename I, int Base, typename U>
+        constexpr size_t parse_digits(std::string_view s, U& u, U limit) noexcept
+        {
+            constexpr U base{Base};
+            U const     quotient{static_cast<U>(limit / base)};
+
+            // Fewer than the max digits of an I can't overflow
+            constexpr size_t unchecked{max_digits<I, Base>() - 1};
+
+            size_t pos{0};
+            for (; pos != s.size(); ++pos)
+            {
+                U digit{digit_values_v[s[pos]]};
+                if (base <= digit)
+                    break;
+
+                if (unchecked <= pos && (quotient < u || limit - digit < u * base))
+                {
+                    // Skip the rest of the digits
+                    while (pos != s.size() && digit_values_v[s[pos]] < base)
+                        ++pos;
+                    return pos | parse_overflow;
+                }
+
+                u = u * base + digit;
+            }
+
+            return pos;
+        }
+
+        // Same as parse_digits<Base>, for a base only known at run time
+        template<typename I, typename U>
+        constexpr size_t parse_digits(std::string_view s, U& u, U limit, U base) noexcept
+        {
+            switch (base)
+            {
+            case 10: return parse_digits<I, 10>(s, u, limit);
+            case 16: return parse_digits<I, 16>(s, u, limit);
+            case  8: return parse_digits<I,  8>(s, u, limit);
+            case  2: return parse_digits<I,  2>(s, u, limit);
+            }
+
+            U const quotient{static_cast<U>(limit / base)};
+            size_t  pos{0};
+            for (; pos != s.size(); ++pos)
+            {
+                U digit{digit_values_v[s[pos]]};
+                if (base <= digit)
+                    break;
+
+                if (quotient < u || limit - digit < u * base)
+                {
+                    while (pos != s.size() && digit_values_v[s[pos]] < base)
+                        ++pos;
+                    return pos | parse_overflow;
+                }
+
+                u = u * base + digit;
+            }
+
+            return pos;
+        }
+
+        template<typename I, int Base>
+        constexpr from_cstring_result<I> from_cstring_integral(std::string_view s, int base) noexcept
+        {
+            static_assert(2 <= Base && Base <= 36);
+            assert(2 <= base && base <= 36);
+
+            using U = magnitude_t<I>;
+
+            bool   negative{is_to_cstring_signed_v<I> && !s.empty() && '-' == s.front()};
+            size_t sign{negative};
+
+            // The most negative value has a magnitude one larger than the most positive
+            U limit{max_magnitude<I>()};
+            if (is_to_cstring_signed_v<I> && !negative)
+                --limit;
+
+            U      u{0};
+            size_t digits{base == Base ? parse_digits<I, Base>(s.substr(sign), u, limit)
+                                       : parse_digits<I>(s.substr(sign), u, limit, U(base))};
+
+            if (parse_overflow & digits)
+                return {I{}, sign + (digits & ~parse_overflow), std::errc::result_out_of_range};
+
+            if (!digits)
+                return {I{}, 0, std::errc::invalid_argument};
+
+            return {negative ? I(U{} - u) : I(u), sign + digits, std::errc{}};
+        }
+
+        inline from_cstring_result<boost::uuids::uuid> from_cstring_uuid(std::string_view s) noexcept
+        {
+            boost::uuids::uuid id{};
+            if (s.size() < uuid_chars || !parse_uuid(s.data(), id.begin()))
+                return {boost::uuids::uuid{}, 0, std::errc::invalid_argument};
+
+            return {id, uuid_chars, std::errc{}};
+        }
+
+    } // detail namespace
+
+    template<typename T, int Base = 10>
+    constexpr from_cstring_result<T> from_cstring(std::string_view s, int base = Base) noexcept
+    {
+        if constexpr(std::is_same_v<T, boost::uuids::uuid>)
+            return detail::from_cstring_uuid(s);
+        else
+        {
+            static_assert(detail::is_to_cstring_integral_v<T>);
+            return detail::from_cstring_integral<T, Base>(s, base);
+        }
+    }
+
+    template<typename T, int Base = 10>
+    constexpr from_cstring_result<size_t> from_cstrings(std::string_view s, T* first, T* last, char separator = ',', int base = Base) noexcept
+    {
+        size_t count{0};
+        size_t pos{0};
+        for (; first != last; ++first, ++count)
+        {
+            size_t start{pos};
+            if (count)
+            {
+                if (pos == s.size() || separator != s[pos])
+                    break;
+                ++start;
+            }
+
+            from_cstring_result<T> result{from_cstring<T, Base>(s.substr(start), base)};
+            if (!result)
+                return {count, pos, result.ec};
+
+            *first = result.value;
+            pos    = start + result.end;
+        }
+
+        return {count, pos, std::errc{}};
+    }
+
+} // cool namespace
+
+#endif /* COOL_FROM_CSTRING_H_ */
@@ -0,0 +1,132 @@
+#ifndef COOL_IS_TRIVIALLY_RELOCATABLE_H_
+#define COOL_IS_TRIVIALLY_RELOCATABLE_H_
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+///////////////////////////////////////////////////////////////////////////////
+// is_trivially_relocatable<T>
+//
+//  Relocating an object means move constructing a new one from it and then
+//  destroying the old one.  A type is trivially relocatable when that is
+//  equivalent to copying its bytes (memcpy) and forgetting about the old
+//  one, which is true for trivially copyable types, but also for most types
+//  which merely own something through a pointer (unique_ptr, shared_ptr,
+//  vector, etc.).  It is not true for types which point into themselves,
+//  such as libstdc++'s std::string or cool::offset_ptr.
+//
+//  It defaults to std::is_trivially_copyable<T>, and is intended to be
+//  specialized (to true) for other types which qualify, as it is here for
+//  std::unique_ptr (with a trivially relocatable deleter), std::shared_ptr,
+//  std::weak_ptr and std::pair.
+//
+//  is_trivially_relocatable_v<T> is the corresponding variable template.
+//
+///////////////////////////////////////////////////////////////////////////////
+//
+// Relocation algorithms
+//
+//  T* relocate_at(T* source, T* dest)
+//      relocates *source to the uninitialized dest
+//
+//  T* uninitialized_relocate(T* first, T* last, T* dest)
+//  T* uninitialized_relocate_n(T* first, size_t n, T* dest)
+//      relocates [first, last) (or [first, first + n)) to the uninitialized
+//      [dest, ...), returning the end of dest.  The ranges may overlap.
+//      For trivially relocatable types this is a single memmove.
+//
+//  If a move constructor throws while relocating non-overlapping ranges, the
+//  objects already constructed in dest are destroyed and the source is left
+//  alone.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template<typename T, typename D>
+    struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+
+    template<typename T>
+    struct is_trivially_relocatable<std::default_delete<T>> : std::true_type {};
+
+    template<typename T>
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+    template<typename T>
+    struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+    template<typename T, typename U>
+    struct is_trivially_relocatable<std::pair<T, U>>
+    : std::bool_constant<is_trivially_relocatable<T>::value && is_trivially_relocatable<U>::value> {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+
+    // T* relocate_at(T* source, T* dest)
+    template<typename T>
+    T* relocate_at(T* source, T* dest)
+    noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+    {
+        if constexpr(is_trivially_relocatable_v<T>)
+        {
+            std::memmove(static_cast<void*>(dest), static_cast<void const*>(source), sizeof(T));
+            return dest;
+        }
+        else
+        {
+            ::new (static_cast<void*>(dest)) T(std::move(*source));
+            source->~T();
+            return dest;
+        }
+    }
+
+    // T* uninitialized_relocate_n(T* first, size_t n, T* dest)
+    template<typename T>
+    T* uninitialized_relocate_n(T* first, size_t n, T* dest)
+    noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+    {
+        if constexpr(is_trivially_relocatable_v<T>)
+        {
+            if (n)
+                std::memmove(static_cast<void*>(dest), static_cast<void const*>(first), n * sizeof(T));
+            return dest + n;
+        }
+        else
+        {
+            // Overlapping ranges are relocated one at a time, from the end
+            // which doesn't overwrite source objects not yet relocated
+            if (dest < first + n && first < dest + n)
+            {
+                if (first < dest)
+                    for (size_t i = n; i--; )
+                        relocate_at(first + i, dest + i);
+                else
+                    for (size_t i = 0; i != n; ++i)
+                        relocate_at(first + i, dest + i);
+
+                return dest + n;
+            }
+
+            std::uninitialized_move_n(first, n, dest);
+            std::destroy_n(first, n);
+            return dest + n;
+        }
+    }
+
+    // T* uninitialized_relocate(T* first, T* last, T* dest)
+    template<typename T>
+    T* uninitialized_relocate(T* first, T* last, T* dest)
+    noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+    { return uninitialized_relocate_n(first, static_cast<size_t>(last - first), dest); }
+
+} // cool namespace
+
+#endif /* COOL_IS_TRIVIALLY_RELOCATABLE_H_ */
@@ -0,0 +1,242 @@
+#ifndef COOL_MAKE_SHARED_FOR_OVERWRITE_H_
+#define COOL_MAKE_SHARED_FOR_OVERWRITE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+// make_shared_for_overwrite<T>
+// allocate_shared_for_overwrite<T>
+//
+//  make_shared_for_overwrite is a replacement for make_shared which default
+//  initializes (as opposed to value initializes) both single objects and
+//  arrays of unknown bounds.  As with make_shared, the object (or array)
+//  and the control block share a single allocation.
+//
+//  allocate_shared_for_overwrite is the same, with the memory coming from an
+//  allocator (such as SlabAllocator).
+//
+//  std::shared_ptr<T> make_shared_for_overwrite<T>()
+//  std::shared_ptr<T> allocate_shared_for_overwrite<T>(a)
+//      default-initialized T
+//
+//  std::shared_ptr<T[]> make_shared_for_overwrite<T[]>(size_t n)
+//  std::shared_ptr<T[]> allocate_shared_for_overwrite<T[]>(a, size_t n)
+//      default-initialized array of T of size n
+//
+//  These are the C++20 std ones when the library has them
+//  (__cpp_lib_smart_ptr_for_overwrite).  Before that, single objects use
+//  allocate_shared with a default_init_allocator, and arrays allocate the
+//  elements right after the control block, through an allocator wrapper
+//  which knows to make room for them.
+//
+//  As with make_unique_for_overwrite, T[N] is not supported.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cool/default_init_allocator.h>
+#include <cool/ebo_wrapper.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cool
+{
+    namespace detail
+    {
+        // make_shared_if are helpers for make_shared_for_overwrite
+        template<typename T>
+        struct make_shared_if
+        { using single_object = std::shared_ptr<T>; };
+
+        template<typename T>
+        struct make_shared_if<T[]>
+        { using array = std::shared_ptr<T[]>; };
+
+        template<typename T, size_t N>
+        struct make_shared_if<T[N]>
+        { using bound = void; };
+
+#if !defined(__cpp_lib_smart_ptr_for_overwrite)
+        // An allocator which, when allocating the control block, makes room
+        // for size Ts after it and stores where they start in *elements
+        template<typename T, typename U, typename A>
+        class shared_array_allocator
+        : private ebo_wrapper<typename std::allocator_traits<A>::template rebind_alloc<T>>
+        {
+            using wrapper = ebo_wrapper<typename std::allocator_traits<A>::template rebind_alloc<T>>;
+
+            template<size_t Alignment>
+            struct alignas(Alignment) block
+            { unsigned char bytes[Alignment]; };
+
+            // The blocks (aligned for both T and U) needed for n Ts and the elements
+            struct layout
+            {
+                constexpr static size_t alignment = alignof(T) < alignof(U) ? alignof(U) : alignof(T);
+                using block_type   = block<alignment>;
+                using block_alloc  = typename std::allocator_traits<A>::template rebind_alloc<block_type>;
+                using block_traits = std::allocator_traits<block_alloc>;
+
+                static size_t elementsOffset(size_t n) noexcept
+                { return (n * sizeof(T) + alignment - 1) & ~(alignment - 1); }
+
+                static size_t blocks(size_t n, size_t size) noexcept
+                { return (elementsOffset(n) + size * sizeof(U) + alignment - 1) / alignment; }
+            };
+
+        public:
+            using value_type = T;
+
+            template<typename TT>
+            struct rebind { using other = shared_array_allocator<TT, U, A>; };
+
+            shared_array_allocator(A const& a, size_t size, U** elements) noexcept
+            : wrapper(a)
+            , m_size{size}
+            , m_elements{elements}
+            {}
+
+            template<typename TT>
+            shared_array_allocator(shared_array_allocator<TT, U, A> const& that) noexcept
+            : wrapper(that.inner_allocator())
+            , m_size{that.m_size}
+            , m_elements{that.m_elements}
+            {}
+
+            typename wrapper::value_type const& inner_allocator() const noexcept
+            { return wrapper::ref(); }
+
+            T* allocate(size_t n)
+            {
+                typename layout::block_alloc blocks(inner_allocator());
+                unsigned char* p = reinterpret_cast<unsigned char*>(layout::block_traits::allocate(blocks, layout::blocks(n, m_size)));
+                *m_elements = reinterpret_cast<U*>(p + layout::elementsOffset(n));
+                return reinterpret_cast<T*>(p);
+            }
+
+            void deallocate(T* p, size_t n) noexcept
+            {
+                typename layout::block_alloc blocks(inner_allocator());
+                layout::block_traits::deallocate(blocks, reinterpret_cast<typename layout::block_type*>(p), layout::blocks(n, m_size));
+            }
+
+            friend bool operator==(shared_array_allocator const& l, shared_array_allocator const& r) noexcept
+            { return l.inner_allocator() == r.inner_allocator() && l.m_elements == r.m_elements; }
+
+            friend bool operator!=(shared_array_allocator const& l, shared_array_allocator const& r) noexcept
+            { return !(l == r); }
+
+        private:
+            template<typename, typename, typename>
+            friend class shared_array_allocator;
+
+            size_t m_size;
+            U**    m_elements;
+        };
+
+        // Owns the default-initialized elements which follow the control block
+        template<typename U>
+        class shared_array_elements
+        {
+        public:
+            shared_array_elements(U* const& elements, size_t size)
+            : m_elements{elements}
+            , m_size{0}
+            {
+                try
+                {
+                    for (; m_size != size; ++m_size)
+                        ::new (static_cast<void*>(m_elements + m_size)) U;
+                }
+                catch (...)
+                {
+                    destroy();
+                    throw;
+                }
+            }
+
+            shared_array_elements(shared_array_elements const&)            = delete;
+            shared_array_elements& operator=(shared_array_elements const&) = delete;
+
+            ~shared_array_elements()
+            { destroy(); }
+
+            U* get() const noexcept
+            { return m_elements; }
+
+        private:
+            void destroy() noexcept
+            {
+                if constexpr(!std::is_trivially_destructible_v<U>)
+                    while (m_size)
+                        m_elements[--m_size].~U();
+            }
+
+            U*     m_elements;
+            size_t m_size;
+        };
+
+        template<typename T, typename A>
+        std::shared_ptr<T> allocate_shared_array_for_overwrite(A const& a, size_t n)
+        {
+            using U        = std::remove_extent_t<T>;
+            using elements = shared_array_elements<U>;
+
+            U*   storage = nullptr;
+            auto owner   = std::allocate_shared<elements>(shared_array_allocator<elements, U, A>(a, n, &storage), storage, n);
+            return std::shared_ptr<T>(owner, owner->get());
+        }
+#endif
+
+    } // detail namespace
+
+    // std::shared_ptr<T> allocate_shared_for_overwrite<T>(a)
+    template<typename T, typename A>
+    typename detail::make_shared_if<T>::single_object
+    allocate_shared_for_overwrite(A const& a)
+    {
+#if defined(__cpp_lib_smart_ptr_for_overwrite)
+        return std::allocate_shared_for_overwrite<T>(a);
+#else
+        using traits = std::allocator_traits<A>;
+        return std::allocate_shared<T>(default_init_allocator<T, typename traits::template rebind_alloc<T>>(a));
+#endif
+    }
+
+    // std::shared_ptr<T[]> allocate_shared_for_overwrite<T[]>(a, size_t n)
+    template<typename T, typename A>
+    typename detail::make_shared_if<T>::array
+    allocate_shared_for_overwrite(A const& a, size_t n)
+    {
+#if defined(__cpp_lib_smart_ptr_for_overwrite)
+        return std::allocate_shared_for_overwrite<T>(a, n);
+#else
+        return detail::allocate_shared_array_for_overwrite<T>(a, n);
+#endif
+    }
+
+    // std::shared_ptr<T> make_shared_for_overwrite<T>()
+    template<typename T>
+    typename detail::make_shared_if<T>::single_object
+    make_shared_for_overwrite()
+    { return cool::allocate_shared_for_overwrite<T>(std::allocator<T>{}); }
+
+    // std::shared_ptr<T[]> make_shared_for_overwrite<T[]>(size_t n)
+    template<typename T>
+    typename detail::make_shared_if<T>::array
+    make_shared_for_overwrite(size_t n)
+    { return cool::allocate_shared_for_overwrite<T>(std::allocator<std::remove_extent_t<T>>{}, n); }
+
+    // make_shared_for_overwrite<T[n]>(Args&&...)
+    template<typename T, typename... Args>
+    typename detail::make_shared_if<T>::bound
+    make_shared_for_overwrite(Args&&...) = delete;
+
+    // allocate_shared_for_overwrite<T[n]>(a, Args&&...)
+    template<typename T, typename A, typename... Args>
+    typename detail::make_shared_if<T>::bound
+    allocate_shared_for_overwrite(A const&, Args&&...) = delete;
+
+} // cool namespace
+
+#endif /* COOL_MAKE_SHARED_FOR_OVERWRITE_H_ */
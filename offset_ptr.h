@@ -0,0 +1,80 @@
+#ifndef COOL_OFFSET_PTR_H_
+#define COOL_OFFSET_PTR_H_
+
+#include <cstddef>      // nullptr_t, ptrdiff_t
+#include <cstdint>      // uintptr_t
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////
+// offset_ptr<T>
+//
+//  offset_ptr is a pointer which stores the distance from itself to what it
+//  points to, instead of an address.  Structures linked with offset_ptrs are
+//  position independent, so they keep working when the memory they live in
+//  (e.g., a MappedFileMemoryResource) is mapped at a different address.
+//
+//  Copying recomputes the offset, so an offset_ptr can be freely copied
+//  to and from anywhere.
+//
+//  An offset of 0 is reserved for nullptr, so an offset_ptr cannot point
+//  to itself.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+    template<typename T>
+    class offset_ptr
+    {
+    public:
+        using element_type    = T;
+        using pointer         = T*;
+        using reference       = std::add_lvalue_reference_t<T>;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr offset_ptr() noexcept = default;
+        constexpr offset_ptr(std::nullptr_t) noexcept {}
+
+        offset_ptr(T* p) noexcept
+        : m_offset{offset(p)}
+        {}
+
+        offset_ptr(offset_ptr const& that) noexcept
+        : m_offset{offset(that.get())}
+        {}
+
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        offset_ptr(offset_ptr<U> const& that) noexcept
+        : m_offset{offset(that.get())}
+        {}
+
+        offset_ptr& operator=(offset_ptr const& that) noexcept
+        { m_offset = offset(that.get()); return *this; }
+
+        offset_ptr& operator=(T* p) noexcept
+        { m_offset = offset(p); return *this; }
+
+        T* get() const noexcept
+        { return m_offset ? reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(this) + m_offset) : nullptr; }
+
+        reference operator*()  const noexcept { return *get(); }
+        T*        operator->() const noexcept { return get(); }
+
+        explicit operator bool() const noexcept { return m_offset; }
+
+        friend bool operator==(offset_ptr const& l, offset_ptr const& r) noexcept
+        { return l.get() == r.get(); }
+
+        friend bool operator!=(offset_ptr const& l, offset_ptr const& r) noexcept
+        { return !(l == r); }
+
+    private:
+        difference_type offset(T const* p) const noexcept
+        { return p ? reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(this) : 0; }
+
+        difference_type m_offset = 0;
+    };
+
+} // cool namespace
+
+#endif /* COOL_OFFSET_PTR_H_ */
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <ostream>
 #include <ratio>
+#include <string_view>
 
 ///////////////////////////////////////////////////////////////////////////////
 // A stream inserter operator for std::ratio
@@ -14,71 +15,85 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace cool { namespace ratio {
-    template<intmax_t N, intmax_t D>
-    std::ostream& operator<<(std::ostream& os, std::ratio<N, D>)
+    namespace detail
     {
-        if (N == 1)
+        // The SI prefix for num / den (such as "kilo"), or empty if there
+        // isn't one; shared with TextBuilder, so both produce the same text
+        constexpr std::string_view prefix(intmax_t num, intmax_t den) noexcept
         {
-            switch (D)
+            if (num == 1)
             {
+                switch (den)
+                {
 #if 0
-            case 1000000000000000000000000:
-                return os << "yocto";
-            case 1000000000000000000000:
-                return os << "zepto";
+                case 1000000000000000000000000:
+                    return "yocto";
+                case 1000000000000000000000:
+                    return "zepto";
 #endif
-            case 1000000000000000000:
-                return os << "atto";
-            case 1000000000000000:
-                return os << "femto";
-            case 1000000000000:
-                return os << "pico";
-            case 1000000000:
-                return os << "nano";
-            case 1000000:
-                return os << "micro";
-            case 1000:
-                return os << "milli";
-            case 100:
-                return os << "centi";
-            case 10:
-                return os << "deci";
-            default:
-                break;
+                case 1000000000000000000:
+                    return "atto";
+                case 1000000000000000:
+                    return "femto";
+                case 1000000000000:
+                    return "pico";
+                case 1000000000:
+                    return "nano";
+                case 1000000:
+                    return "micro";
+                case 1000:
+                    return "milli";
+                case 100:
+                    return "centi";
+                case 10:
+                    return "deci";
+                default:
+                    break;
+                }
             }
-        }
 
-        if (D == 1)
-        {
-            switch (N)
+            if (den == 1)
             {
-            case 10:
-                return os << "deca";
-            case 100:
-                return os << "hecto";
-            case 1000:
-                return os << "kilo";
-            case 1000000:
-                return os << "mega";
-            case 1000000000:
-                return os << "giga";
-            case 1000000000000:
-                return os << "tera";
-            case 1000000000000000:
-                return os << "peta";
-            case 1000000000000000000:
-                return os << "exa";
+                switch (num)
+                {
+                case 10:
+                    return "deca";
+                case 100:
+                    return "hecto";
+                case 1000:
+                    return "kilo";
+                case 1000000:
+                    return "mega";
+                case 1000000000:
+                    return "giga";
+                case 1000000000000:
+                    return "tera";
+                case 1000000000000000:
+                    return "peta";
+                case 1000000000000000000:
+                    return "exa";
 #if 0
-            case 1000000000000000000000:
-                return os << "zetta";
-            case 1000000000000000000000000:
-                return os << "yotta";
+                case 1000000000000000000000:
+                    return "zetta";
+                case 1000000000000000000000000:
+                    return "yotta";
 #endif
-            default:
-                break;
+                default:
+                    break;
+                }
             }
+
+            return {};
         }
 
+    } // detail namespace
+
+    template<intmax_t N, intmax_t D>
+    std::ostream& operator<<(std::ostream& os, std::ratio<N, D>)
+    {
+        if (constexpr std::string_view prefix{detail::prefix(N, D)}; !prefix.empty())
+            return os << prefix;
+
         return os << "ratio<" << N << ',' << D << '>';
     }
 
@@ -0,0 +1,102 @@
+#ifndef COOL_RESIZE_FOR_OVERWRITE_H_
+#define COOL_RESIZE_FOR_OVERWRITE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+// resize_for_overwrite
+//
+//  default_init_allocator cannot help std::basic_string, since basic_string
+//  fills new characters with char_traits::assign instead of calling
+//  allocator construct.  These resize a string without writing the new
+//  characters (other than the terminating '\0'), for buffers which are about
+//  to be filled by read(2), recv(2), memcpy, etc.
+//
+//  Which characters get written depends on the library:
+//
+//      C++23 (__cpp_lib_string_resize_and_overwrite)
+//                  - basic_string::resize_and_overwrite
+//      libstdc++ with basic_string::__resize_and_overwrite (its C++11 and
+//      later extension, in newer releases; detected, not version checked)
+//                  - the same, before C++23
+//      otherwise   - resize(), which value initializes the new characters,
+//                    so there is no gain (this includes libstdc++ 12 in
+//                    C++17/20); resize_for_overwrite_is_uninitialized_v
+//                    tells which
+//
+//  size_t resize_and_overwrite(s, n, op)
+//      same as s.resize_and_overwrite(n, op):  op(s.data(), n) writes up to
+//      n characters and returns how many to keep
+//
+//  void resize_for_overwrite(s, n)
+//      s.size() == n, with indeterminate characters in [old size, n)
+//
+//  CharT* append_for_overwrite(s, n)
+//      grows s by n indeterminate characters and returns a pointer to them
+//
+//  resize_for_overwrite_is_uninitialized_v<String>
+//      true unless these fall back to resize() for String
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace cool
+{
+    namespace detail
+    {
+        // Does String have libstdc++'s __resize_and_overwrite extension?
+        template<typename String, typename = void>
+        struct has_resize_and_overwrite_extension
+        : std::false_type {};
+
+        template<typename String>
+        struct has_resize_and_overwrite_extension<String, std::void_t<decltype(std::declval<String&>().__resize_and_overwrite(
+            size_t{}, std::declval<size_t (*)(typename String::value_type*, size_t)>()))>>
+        : std::true_type {};
+
+    } // detail namespace
+
+    template<typename String>
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    inline constexpr bool resize_for_overwrite_is_uninitialized_v = true;
+#else
+    inline constexpr bool resize_for_overwrite_is_uninitialized_v = detail::has_resize_and_overwrite_extension<String>::value;
+#endif
+
+    // size_t resize_and_overwrite(s, n, op)
+    template<typename CharT, typename Traits, typename A, typename Op>
+    size_t resize_and_overwrite(std::basic_string<CharT, Traits, A>& s, size_t n, Op op)
+    {
+#if defined(__cpp_lib_string_resize_and_overwrite)
+        s.resize_and_overwrite(n, std::move(op));
+#else
+        if constexpr(detail::has_resize_and_overwrite_extension<std::basic_string<CharT, Traits, A>>::value)
+            s.__resize_and_overwrite(n, std::move(op));
+        else
+        {
+            s.resize(n);
+            s.resize(static_cast<size_t>(std::move(op)(s.data(), n)));
+        }
+#endif
+        return s.size();
+    }
+
+    // void resize_for_overwrite(s, n)
+    template<typename CharT, typename Traits, typename A>
+    void resize_for_overwrite(std::basic_string<CharT, Traits, A>& s, size_t n)
+    { resize_and_overwrite(s, n, [](CharT*, size_t size) noexcept { return size; }); }
+
+    // CharT* append_for_overwrite(s, n)
+    template<typename CharT, typename Traits, typename A>
+    CharT* append_for_overwrite(std::basic_string<CharT, Traits, A>& s, size_t n)
+    {
+        size_t size = s.size();
+        resize_for_overwrite(s, size + n);
+        return s.data() + size;
+    }
+
+} // cool namespace
+
+#endif /* COOL_RESIZE_FOR_OVERWRITE_H_ */
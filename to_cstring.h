@@ -1,21 +1,26 @@
 #ifndef COOL_TO_CSTRING_H_
 #define COOL_TO_CSTRING_H_
 
+#include <cool/to_cstring_core.h>
+#include <cool/uuid_chars.h>
+
 #include <boost/uuid/uuid.hpp>
 
-#include <algorithm>    // copy
+#include <algorithm>    // copy, max, transform
 #include <array>
 #include <cassert>
+#include <charconv>     // to_chars
 #include <climits>      // CHAR_BIT
 #include <cstddef>      // size_t, ptrdiff_t
 #include <cstdint>      // uint_fast*_t
 #include <iterator>     // reverse_iterator
+#include <limits>       // numeric_limits
 #include <ostream>
 #include <string>       // char_traits
 #include <string_view>
 #include <tuple>
 #include <type_traits>
-#include <utility>      // swap
+#include <utility>      // exchange, swap
 
 namespace cool
 {
@@ -23,7 +28,61 @@ namespace cool
     class to_cstring;
 
     ///////////////////////////////////////////////////////////////////////////
-    // to_cstring<I, integral_constant<int, Base>>`
+    // to_cstring_options<Width, Fill, Separator, Group, Plus, Uppercase>
+    //
+    //  Compile time formatting options for integral to_cstrings:
+    //
+    //  Width       - pad to at least Width chars with Fill (default ' ');
+    //                when Fill is '0' the zeroes go after the sign, as in
+    //                -0042, otherwise the fill goes before it, as in "  -42"
+    //  Separator   - if not '\0', put Separator between every Group (default
+    //                3) digits, counting from the right, as in 1,234,567
+    //                (padding is never grouped)
+    //  Plus        - start non-negative values with '+'
+    //  Uppercase   - digits 10..35 are A..Z instead of a..z
+    //
+    //  The defaults format exactly as to_cstring does without options.  As
+    //  the parameters are positional, there are aliases for changing them:
+    //
+    //      to_cstring_options<>::with_width<8, '0'>
+    //      to_cstring_options<>::with_grouping<','>::with_plus
+    //      to_cstring_options<>::with_uppercase
+    //
+    ///////////////////////////////////////////////////////////////////////////
+    template<size_t Width = 0, char Fill = ' ', char Separator = '\0', size_t Group = 3, bool Plus = false, bool Uppercase = false>
+    struct to_cstring_options
+    {
+        static_assert(0 < Group);
+
+        static const constexpr size_t width     = Width;
+        static const constexpr char   fill      = Fill;
+        static const constexpr char   separator = Separator;
+        static const constexpr size_t group     = Group;
+        static const constexpr bool   plus      = Plus;
+        static const constexpr bool   uppercase = Uppercase;
+
+        template<size_t W, char F = Fill>
+        using with_width     = to_cstring_options<W, F, Separator, Group, Plus, Uppercase>;
+
+        template<char S, size_t G = Group>
+        using with_grouping  = to_cstring_options<Width, Fill, S, G, Plus, Uppercase>;
+
+        using with_plus      = to_cstring_options<Width, Fill, Separator, Group, true, Uppercase>;
+        using with_uppercase = to_cstring_options<Width, Fill, Separator, Group, Plus, true>;
+    };
+
+    namespace detail
+    {
+        template<typename T>
+        inline constexpr bool is_to_cstring_options_v = false;
+
+        template<size_t Width, char Fill, char Separator, size_t Group, bool Plus, bool Uppercase>
+        inline constexpr bool is_to_cstring_options_v<to_cstring_options<Width, Fill, Separator, Group, Plus, Uppercase>> = true;
+
+    } // detail namespace
+
+    ///////////////////////////////////////////////////////////////////////////
+    // to_cstring<I, integral_constant<int, Base>, Options = to_cstring_options<>>`
     //
     //  to_cstring is a non-allocating owning string
     //  which holds an integral value converted to a character string.
@@ -35,6 +94,13 @@ namespace cool
     //  10..35 (inclusive) are represented as lowercase characters a..z.  If
     //  the value is less than zero, the representation starts with '-'.
     //
+    //  Options (see to_cstring_options) can add padding, digit grouping, a
+    //  '+' and uppercase digits; max_size() grows to make room for them, so
+    //  it is still a fixed size buffer (and there are no locales involved).
+    //  The Options can be deduced, as in
+    //  to_cstring(value, to_cstring_options<>::with_grouping<','>{}) or
+    //  to_cstring(value, std::integral_constant<int, 16>{}, options).
+    //
     //  One example of using this is printf("%s\n", to_cstring(value).c_str());
     //  * Like streams, you don't have to know the exact type of value passed
     //    to it, as a templated constructor takes care of that
@@ -45,11 +111,13 @@ namespace cool
     std::ostream& operator<<(std::ostream& os, to_cstring<Ts...> const&& that)
     { return os << std::move(that).c_str(); }
 
-    template<typename I, int Base>
-    class to_cstring<I, std::integral_constant<int, Base>>
+    template<typename I, int Base, typename... Options>
+    class to_cstring<I, std::integral_constant<int, Base>, Options...>
     {
-        static_assert(std::is_integral_v<I> || std::is_same_v<I, __int128_t> || std::is_same_v<I, __uint128_t>);
+        static_assert(detail::is_to_cstring_integral_v<I>);
         static_assert(2 <= Base && Base <= 36);
+        static_assert(sizeof...(Options) <= 1);
+        static_assert((detail::is_to_cstring_options_v<Options> && ...));
 
     public:
         // types
@@ -69,10 +137,19 @@ namespace cool
 
         using element_type                    = I;
         static const constexpr int min_base   = Base;
+        using options_type                    = std::tuple_element_t<0, std::tuple<Options..., to_cstring_options<>>>;
 
         // public constructors
         explicit to_cstring(I i, int base = Base) noexcept
-        : to_cstring{i < I{}, magnitude_type(i < I{} ? -i : i), magnitude_type(base)}
+        : to_cstring{i < I{}, detail::magnitude(i), magnitude_type(base)}
+        {}
+
+        to_cstring(I i, options_type) noexcept
+        : to_cstring{i}
+        {}
+
+        to_cstring(I i, std::integral_constant<int, Base>, options_type) noexcept
+        : to_cstring{i}
         {}
 
         // Copying added for efficiency (compiler-generated copy/move are correct but may copy more stuff))
@@ -112,20 +189,10 @@ namespace cool
         static constexpr bool      empty()    noexcept { return false; }
         static constexpr size_type max_size() noexcept
         {
-            // size starts out as is_signed, thus making room for '-' when true
-            // magnitude starts out as the max magnitude: if is_signed, then 0x800... else 0xfff...
-            // Run the same algorithm for counting bytes needed for is_signed + max magnitude
-            // as to_cstring constructor uses to assign the chars
-            // Assumes 2s complement
-            size_type      size{I(-1) < I{}};
-            magnitude_type magnitude{static_cast<magnitude_type>(size ? magnitude_type(1) << (CHAR_BIT * sizeof(I) - 1) : magnitude_type(I(-1)))};
-            do
-            {
-                ++size;
-                magnitude /= magnitude_type{Base};
-            } while (magnitude);
-
-            return size;
+            constexpr size_type digits{detail::max_digits<I, Base>()};
+            constexpr size_type chars{(detail::is_to_cstring_signed_v<I> || options_type::plus) + digits
+                                      + ('\0' != options_type::separator) * ((digits - 1) / options_type::group)};
+            return std::max(chars, options_type::width);
         }
 
         // element access
@@ -189,14 +256,7 @@ namespace cool
 
     private:
         // Unsigned type for performing I to cstring
-        // Indexed by sizeof(I)
-        using magnitude_type = std::tuple_element_t<sizeof(I), std::tuple<void
-            , uint_fast8_t
-            , uint_fast16_t
-            , uint_fast32_t, uint_fast32_t
-            , uint_fast64_t, uint_fast64_t, uint_fast64_t, uint_fast64_t
-            , __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t
-        >>;
+        using magnitude_type = detail::magnitude_t<I>;
 
         // cstring_type is large enough to hold max_size() chars and the trailing '\0'
         using cstring_type = std::array<char, max_size() + sizeof('\0')>;
@@ -208,16 +268,45 @@ namespace cool
         {
             assert(Base <= base && base <= 36);
 
-            m_cstring[m_pos] = '\0';
-            do
+            // The fast, compile time Base path is the usual case
+            char* last  = m_cstring.data() + m_pos;
+            char* first = base == Base ? detail::format_backward<Base>(last, magnitude)
+                                       : detail::format_backward(last, magnitude, base);
+            *last = '\0';
+
+            if constexpr(options_type::uppercase)
             {
-                m_cstring[--m_pos] = "0123456789abcdefghijklmnopqrstuvwxyz"[magnitude % base];
-                magnitude /= base;
+                if (10 < base)
+                    std::transform(first, last, first, [](char c) { return 'a' <= c ? static_cast<char>(c - 'a' + 'A') : c; });
             }
-            while (magnitude);
 
-            if (negative)
-                m_cstring[--m_pos] = '-';
+            if constexpr('\0' != options_type::separator)
+                first = detail::group_backward(first, last, options_type::separator, options_type::group);
+
+            char sign{negative ? '-' : options_type::plus ? '+' : '\0'};
+            if constexpr(0 != options_type::width)
+            {
+                char* const pad{last - std::max<size_type>(options_type::width, static_cast<size_type>(last - first) + !!sign)};
+                if constexpr('0' == options_type::fill)
+                {
+                    // zeroes go between the sign and the digits
+                    while (first - !!sign != pad)
+                        *--first = '0';
+                }
+                else
+                {
+                    if (sign)
+                        *--first = std::exchange(sign, '\0');
+
+                    while (first != pad)
+                        *--first = options_type::fill;
+                }
+            }
+
+            if (sign)
+                *--first = sign;
+
+            m_pos = static_cast<size_type>(first - m_cstring.data());
         }
 
         cstring_type m_cstring;
@@ -225,13 +314,185 @@ namespace cool
     };
 
     // Single parameter constructor assumes base 10
-    template<typename I, typename = std::enable_if_t<std::is_integral_v<I> || std::is_same_v<I, __int128_t> || std::is_same_v<I, __uint128_t>>>
+    template<typename I, typename = std::enable_if_t<detail::is_to_cstring_integral_v<I>>>
     explicit to_cstring(I) -> to_cstring<I, std::integral_constant<int, 10>>;
 
     // Two parameter constructor uses the one that can hold the largest magnitude, which is base 2
-    template<typename I, typename = std::enable_if_t<std::is_integral_v<I> || std::is_same_v<I, __int128_t> || std::is_same_v<I, __uint128_t>>>
+    template<typename I, typename = std::enable_if_t<detail::is_to_cstring_integral_v<I>>>
     explicit to_cstring(I, int) -> to_cstring<I, std::integral_constant<int, 2>>;
 
+    // Options are in base 10 unless the Base is also given
+    template<typename I, typename Options, typename = std::enable_if_t<detail::is_to_cstring_integral_v<I> && detail::is_to_cstring_options_v<Options>>>
+    to_cstring(I, Options) -> to_cstring<I, std::integral_constant<int, 10>, Options>;
+
+    template<typename I, int Base, typename Options, typename = std::enable_if_t<detail::is_to_cstring_integral_v<I> && detail::is_to_cstring_options_v<Options>>>
+    to_cstring(I, std::integral_constant<int, Base>, Options) -> to_cstring<I, std::integral_constant<int, Base>, Options>;
+
+#if defined(__cpp_lib_to_chars)
+    ///////////////////////////////////////////////////////////////////////////
+    // to_cstring<F, integral_constant<chars_format, Format>>
+    //
+    //  to_cstring is a non-allocating owning string
+    //  which holds a float or double converted to a character string.
+    //
+    //  The value is converted with std::to_chars (no locale) to the shortest
+    //  representation which round trips (reads back as the same value):
+    //
+    //  shortest_chars_format (the default) - the shorter of fixed and scientific
+    //  chars_format::fixed                 - fixed (which may be long)
+    //  chars_format::scientific            - scientific
+    //  chars_format::general               - like printf %g
+    //
+    //  Infinities and NaNs are inf, -inf, nan and -nan.
+    //
+    //  The Format can be deduced from a chars_format_constant, as in
+    //  to_cstring(d, chars_format_constant<std::chars_format::fixed>{}).
+    //
+    ///////////////////////////////////////////////////////////////////////////
+    inline constexpr std::chars_format shortest_chars_format{};
+
+    template<std::chars_format Format>
+    using chars_format_constant = std::integral_constant<std::chars_format, Format>;
+
+    template<typename F, std::chars_format Format>
+    class to_cstring<F, std::integral_constant<std::chars_format, Format>>
+    {
+        static_assert(std::is_same_v<F, float> || std::is_same_v<F, double>);
+
+    public:
+        // types
+        using value_type                      = char;
+        using traits_type                     = std::char_traits<value_type>;
+        using pointer                         = value_type*;
+        using const_pointer                   = const value_type*;
+        using reference                       = value_type&;
+        using const_reference                 = const value_type&;
+        using const_iterator                  = const_pointer;
+        using iterator                        = const_iterator;
+        using const_reverse_iterator          = std::reverse_iterator<const_iterator>;
+        using reverse_iterator                = const_reverse_iterator;
+        using size_type                       = std::size_t;
+        using difference_type                 = std::ptrdiff_t;
+        static const constexpr size_type npos = static_cast<size_type>(-1);
+
+        using element_type                    = F;
+        static const constexpr std::chars_format format = Format;
+
+        // public constructors
+        explicit to_cstring(F f) noexcept
+        {
+            std::to_chars_result result{shortest_chars_format == Format
+                ? std::to_chars(m_cstring.data(), m_cstring.data() + max_size(), f)
+                : std::to_chars(m_cstring.data(), m_cstring.data() + max_size(), f, Format)};
+            assert(std::errc{} == result.ec);
+
+            *result.ptr = '\0';
+            m_size = static_cast<size_type>(result.ptr - m_cstring.data());
+        }
+
+        to_cstring(F f, std::integral_constant<std::chars_format, Format>) noexcept
+        : to_cstring{f}
+        {}
+
+        // iterator support
+        const_iterator         begin()   const noexcept { return m_cstring.data(); }
+        const_iterator         end()     const noexcept { return m_cstring.data() + m_size; }
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator{end()}; }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator{begin()}; }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend()   const noexcept { return rend(); }
+
+        // capacity
+        size_type size()                const noexcept { return m_size; }
+        size_type length()              const noexcept { return size(); }
+        static constexpr bool      empty()    noexcept { return false; }
+        static constexpr size_type max_size() noexcept
+        {
+            using limits = std::numeric_limits<F>;
+
+            // Fixed is either all integral digits or "0." followed by up to
+            // -min_exponent10 zeroes (more for subnormals) and the significant digits
+            if constexpr(std::chars_format::fixed == Format)
+                return sizeof('-') + std::max<size_type>(limits::max_exponent10 + 1,
+                                                         sizeof("0.") - 1 + -limits::min_exponent10 + limits::max_digits10);
+
+            // Otherwise, no longer than scientific:  -d.ddde-ddd
+            size_type exponent_digits{0};
+            for (int e = -limits::min_exponent10 + limits::max_digits10; e; e /= 10)
+                ++exponent_digits;
+
+            return sizeof('-') + limits::max_digits10 + sizeof('.') + sizeof('e') + sizeof('-') + exponent_digits;
+        }
+
+        // element access
+        const_reference operator[](size_type pos) const          { return m_cstring[pos]; }
+        const_reference at(size_type pos)         const          { return m_cstring.at(pos); }
+        const_reference front()                   const noexcept { return m_cstring.front(); }
+        const_reference back()                    const noexcept { return m_cstring[m_size - 1]; }
+
+        // string operations
+        const_pointer   data()             const noexcept { return begin(); }
+        const_pointer   c_str()            const noexcept { return begin(); }
+        operator        std::string_view() const noexcept { return std::string_view{data(), size()}; }
+
+        // comparisons
+        // Note:  these do string comparisons, not numeric comparisons
+        friend bool operator==(to_cstring const& l, to_cstring const& r) noexcept
+        { return std::equal(l.begin(), l.end(), r.begin(), r.end()); }
+
+        friend bool operator!=(to_cstring const& l, to_cstring const& r) noexcept
+        { return !(l == r); }
+
+        friend bool operator<(to_cstring const& l, to_cstring const& r) noexcept
+        { return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end()); }
+
+        friend bool operator>(to_cstring const& l, to_cstring const& r) noexcept
+        { return r < l; }
+
+        friend bool operator<=(to_cstring const& l, to_cstring const& r) noexcept
+        { return !(r < l); }
+
+        friend bool operator>=(to_cstring const& l, to_cstring const& r) noexcept
+        { return !(l < r); }
+
+        // swap
+        friend void swap(to_cstring& l, to_cstring& r) noexcept
+        {
+            // Only the chars in use (and the '\0') need to be swapped
+            size_type size = std::max(l.m_size, r.m_size) + sizeof('\0');
+            std::swap_ranges(l.m_cstring.begin(), l.m_cstring.begin() + size, r.m_cstring.begin());
+
+            using std::swap;
+            swap(l.m_size, r.m_size);
+        }
+
+        void swap(to_cstring& that) noexcept
+        {
+            using std::swap;
+            swap(*this, that);
+        }
+
+        // We can stream this even if it isn't a temporary
+        friend std::ostream& operator<<(std::ostream& os, to_cstring const& that)
+        { return os << that.c_str(); }
+
+    private:
+        // cstring_type is large enough to hold max_size() chars and the trailing '\0'
+        using cstring_type = std::array<char, max_size() + sizeof('\0')>;
+
+        cstring_type m_cstring;
+        size_type    m_size;
+    };
+
+    template<typename F, typename = std::enable_if_t<std::is_floating_point_v<F>>>
+    explicit to_cstring(F) -> to_cstring<F, chars_format_constant<shortest_chars_format>>;
+
+    template<typename F, std::chars_format Format>
+    to_cstring(F, std::integral_constant<std::chars_format, Format>) -> to_cstring<F, chars_format_constant<Format>>;
+#endif
+
 
     // Extend to wrapping std::string so it has a consistent interface
     template<>
@@ -290,20 +551,8 @@ namespace cool
         using element_type                    = boost::uuids::uuid;
 
         // public constructors
-        explicit to_cstring(element_type const& id)
-        {
-            cstring_type::iterator out{m_cstring.begin()};
-            uint_fast16_t          dashes{0b1010101000};
-            for (uint8_t uc : id)
-            {
-                *out++ = "0123456789abcdef"[uc / 16];
-                *out++ = "0123456789abcdef"[uc % 16];
-                if (1 & dashes)
-                    *out++ = '-';
-                dashes >>= 1;
-            }
-            *out = '\0';
-        }
+        explicit to_cstring(element_type const& id) noexcept
+        { *detail::format_uuid(id.begin(), m_cstring.data()) = '\0'; }
 
         // iterator support
         const_iterator         begin()   const noexcept { return m_cstring.begin(); }
@@ -0,0 +1,349 @@
+#ifndef COOL_TO_CSTRING_CORE_H_
+#define COOL_TO_CSTRING_CORE_H_
+
+#include <climits>      // CHAR_BIT
+#include <cstddef>      // size_t
+#include <cstdint>      // uint_fast*_t
+#include <tuple>
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////
+// to_cstring_core
+//
+//  The integer to characters conversion shared by to_cstring and c_str_t.
+//  Everything here is constexpr and writes the digits backwards, ending at
+//  a given position, so callers can size their buffers with max_digits and
+//  format into the end of them.
+//
+//  format_backward<Base>(last, magnitude) picks the algorithm at compile
+//  time from Base:
+//
+//      10              - two digits at a time from a 200 byte table of
+//                        digit pairs (dividing by the constant 100, which
+//                        compilers turn into a multiply by its reciprocal).
+//                        __uint128_t values are first split into 19 digit
+//                        chunks, so there are at most two 128-bit divides.
+//      16              - two digits (one byte) at a time from a table of
+//                        hex digit pairs, using shifts and masks
+//      2, 4, 8, 32     - one digit at a time, using shifts and masks
+//      anything else   - one digit at a time, dividing by the constant Base
+//
+//  format_backward(last, magnitude, base) is the fallback for a base only
+//  known at run time.
+//
+//  count_digits<Base>(magnitude) is the number of digits format_backward
+//  writes, computed from the bit width (count leading zeroes) for Base 10
+//  and powers of 2, so callers can format forwards.
+//
+//  group_backward(first, last, separator, group) spreads formatted digits
+//  out (in place) with a separator between groups, such as 1,234,567.
+//
+//  Digits in the range 10..35 (inclusive) are lowercase characters a..z.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+namespace detail
+{
+    // Unsigned type for performing I to cstring
+    // Indexed by sizeof(I)
+    template<typename I>
+    using magnitude_t = std::tuple_element_t<sizeof(I), std::tuple<void
+        , uint_fast8_t
+        , uint_fast16_t
+        , uint_fast32_t, uint_fast32_t
+        , uint_fast64_t, uint_fast64_t, uint_fast64_t, uint_fast64_t
+        , __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t, __uint128_t
+    >>;
+
+    template<typename I>
+    inline constexpr bool is_to_cstring_integral_v = std::is_integral_v<I> || std::is_same_v<I, __int128_t> || std::is_same_v<I, __uint128_t>;
+
+    template<typename I>
+    inline constexpr bool is_to_cstring_signed_v = I(-1) < I{};
+
+    // |i| (well defined for the most negative value, assuming 2s complement)
+    template<typename I>
+    constexpr magnitude_t<I> magnitude(I i) noexcept
+    { return i < I{} ? magnitude_t<I>(magnitude_t<I>{} - magnitude_t<I>(i)) : magnitude_t<I>(i); }
+
+    // The largest magnitude of I:  if signed, then 0x800... else 0xfff...
+    template<typename I>
+    constexpr magnitude_t<I> max_magnitude() noexcept
+    {
+        return is_to_cstring_signed_v<I> ? magnitude_t<I>(magnitude_t<I>(1) << (CHAR_BIT * sizeof(I) - 1))
+                                         : magnitude_t<I>(I(-1));
+    }
+
+    // Number of digits needed for any magnitude of I in Base
+    template<typename I, int Base>
+    constexpr size_t max_digits() noexcept
+    {
+        size_t         digits{0};
+        magnitude_t<I> m{max_magnitude<I>()};
+        do
+        {
+            ++digits;
+            m /= magnitude_t<I>(Base);
+        } while (m);
+
+        return digits;
+    }
+
+    // Number of chars needed for any I in Base (making room for '-' when signed)
+    template<typename I, int Base>
+    constexpr size_t max_chars() noexcept
+    { return is_to_cstring_signed_v<I> + max_digits<I, Base>(); }
+
+    inline constexpr char digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    // digits[2 * n], digits[2 * n + 1] are the two digits of n in Base
+    template<int Base>
+    struct digit_pairs
+    {
+        constexpr digit_pairs() noexcept
+        : digits{}
+        {
+            for (int n = 0; n != Base * Base; ++n)
+            {
+                digits[2 * n]     = digit_chars[n / Base];
+                digits[2 * n + 1] = digit_chars[n % Base];
+            }
+        }
+
+        char digits[2 * Base * Base];
+    };
+
+    template<int Base>
+    inline constexpr digit_pairs<Base> digit_pairs_v{};
+
+    template<int Base>
+    inline constexpr bool is_power_of_2_v = !(Base & (Base - 1));
+
+    template<int Base>
+    constexpr int log2() noexcept
+    { return 1 + log2<Base / 2>(); }
+
+    template<>
+    constexpr int log2<1>() noexcept
+    { return 0; }
+
+    // Writes pair (< Base * Base) as two digits ending at last
+    template<int Base>
+    constexpr char* format_pair_backward(char* last, unsigned pair) noexcept
+    {
+        *--last = digit_pairs_v<Base>.digits[2 * pair + 1];
+        *--last = digit_pairs_v<Base>.digits[2 * pair];
+        return last;
+    }
+
+    // Writes u as exactly Digits decimal digits (with leading zeroes) ending at last
+    template<int Digits>
+    constexpr char* format_decimal_fixed_backward(char* last, uint_fast64_t u) noexcept
+    {
+        for (int d = Digits; 1 < d; d -= 2)
+        {
+            last = format_pair_backward<10>(last, static_cast<unsigned>(u % 100));
+            u /= 100;
+        }
+
+        if constexpr(Digits % 2)
+            *--last = digit_chars[u];
+
+        return last;
+    }
+
+    template<typename U>
+    constexpr char* format_decimal_backward(char* last, U u) noexcept
+    {
+        if constexpr(sizeof(uint_fast64_t) < sizeof(U))
+        {
+            // Peel off 19 digits at a time with a (slow) 128-bit divide,
+            // so the rest can be done with (fast) 64-bit arithmetic
+            constexpr uint_fast64_t e19{10'000'000'000'000'000'000u};
+            while (U(~uint_fast64_t{}) < u)
+            {
+                U q{u / e19};
+                last = format_decimal_fixed_backward<19>(last, static_cast<uint_fast64_t>(u - q * e19));
+                u = q;
+            }
+
+            return format_decimal_backward(last, static_cast<uint_fast64_t>(u));
+        }
+        else
+        {
+            while (100 <= u)
+            {
+                last = format_pair_backward<10>(last, static_cast<unsigned>(u % 100));
+                u /= 100;
+            }
+
+            if (10 <= u)
+                return format_pair_backward<10>(last, static_cast<unsigned>(u));
+
+            *--last = digit_chars[u];
+            return last;
+        }
+    }
+
+    template<typename U>
+    constexpr char* format_hex_backward(char* last, U u) noexcept
+    {
+        while (0xff < u)
+        {
+            last = format_pair_backward<16>(last, static_cast<unsigned>(u & 0xff));
+            u >>= 8;
+        }
+
+        if (0xf < u)
+            return format_pair_backward<16>(last, static_cast<unsigned>(u));
+
+        *--last = digit_chars[u];
+        return last;
+    }
+
+    // powers_of_10[n] is 10^n (except powers_of_10[0], which is 0; see count_digits)
+    struct powers_of_10
+    {
+        constexpr powers_of_10() noexcept
+        : powers{}
+        {
+            __uint128_t power{1};
+            for (auto& p : powers)
+            {
+                p = power;
+                power *= 10;
+            }
+            powers[0] = 0;
+        }
+
+        __uint128_t powers[39];
+    };
+
+    inline constexpr powers_of_10 powers_of_10_v{};
+
+    // Number of bits needed to represent u (at least 1)
+    template<typename U>
+    constexpr int bit_width(U u) noexcept
+    {
+        if constexpr(sizeof(unsigned long long) < sizeof(U))
+        {
+            unsigned long long high{static_cast<unsigned long long>(u >> (CHAR_BIT * sizeof(unsigned long long)))};
+            if (high)
+                return CHAR_BIT * sizeof(unsigned long long) + bit_width(high);
+
+            return bit_width(static_cast<unsigned long long>(u));
+        }
+        else
+            return CHAR_BIT * sizeof(unsigned long long) - __builtin_clzll(static_cast<unsigned long long>(u) | 1);
+    }
+
+    // Number of digits in u (at least 1), without dividing when Base is 10 or a power of 2
+    template<int Base, typename U>
+    constexpr size_t count_digits(U u) noexcept
+    {
+        static_assert(2 <= Base && Base <= 36);
+
+        if constexpr(10 == Base)
+        {
+            // 1233 / 4096 is just over log10(2), giving either the digit count or one more;
+            // comparing against the power of 10 tells which (0 having 1 digit)
+            int approximation{bit_width(u) * 1233 >> 12};
+            return static_cast<size_t>(approximation + 1 - (u < powers_of_10_v.powers[approximation]));
+        }
+        else if constexpr(is_power_of_2_v<Base>)
+            return static_cast<size_t>((bit_width(u) + log2<Base>() - 1) / log2<Base>());
+        else
+        {
+            size_t digits{0};
+            do
+            {
+                ++digits;
+                u /= U(Base);
+            } while (u);
+
+            return digits;
+        }
+    }
+
+    // Writes the digits of u in Base, ending at last; returns the first digit
+    template<int Base, typename U>
+    constexpr char* format_backward(char* last, U u) noexcept
+    {
+        static_assert(2 <= Base && Base <= 36);
+
+        if constexpr(10 == Base)
+            return format_decimal_backward(last, u);
+        else if constexpr(16 == Base)
+            return format_hex_backward(last, u);
+        else if constexpr(is_power_of_2_v<Base>)
+        {
+            do
+            {
+                *--last = digit_chars[u & U(Base - 1)];
+                u >>= log2<Base>();
+            } while (u);
+
+            return last;
+        }
+        else
+        {
+            do
+            {
+                *--last = digit_chars[u % U(Base)];
+                u /= U(Base);
+            } while (u);
+
+            return last;
+        }
+    }
+
+    // Writes the digits of u in base (only known at run time), ending at last;
+    // returns the first digit
+    template<typename U>
+    constexpr char* format_backward(char* last, U u, U base) noexcept
+    {
+        switch (base)
+        {
+        case 10: return format_backward<10>(last, u);
+        case 16: return format_backward<16>(last, u);
+        case  8: return format_backward< 8>(last, u);
+        case  2: return format_backward< 2>(last, u);
+        }
+
+        do
+        {
+            *--last = digit_chars[u % base];
+            u /= base;
+        } while (u);
+
+        return last;
+    }
+
+    // Inserts separator between every group digits (counting from the right)
+    // of [first, last), moving them towards the front; returns the new first
+    constexpr char* group_backward(char* first, char* last, char separator, size_t group) noexcept
+    {
+        size_t digits{static_cast<size_t>(last - first)};
+        if (digits <= group)
+            return first;
+
+        // The leftmost digits move the furthest, so moving them first
+        // never overwrites a digit which hasn't moved yet
+        size_t separators{(digits - 1) / group};
+        char*  out{first - separators};
+        for (size_t d = digits; d; --d)
+        {
+            *out++ = *first++;
+            if (1 != d && 0 == (d - 1) % group)
+                *out++ = separator;
+        }
+
+        return last - digits - separators;
+    }
+
+} // detail namespace
+} // cool namespace
+
+#endif /* COOL_TO_CSTRING_CORE_H_ */
@@ -0,0 +1,99 @@
+#ifndef COOL_TO_CSTRINGS_H_
+#define COOL_TO_CSTRINGS_H_
+
+#include <cool/to_cstring_core.h>
+#include <cool/uuid_chars.h>
+
+#include <boost/uuid/uuid.hpp>
+
+#include <cstddef>      // size_t
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////
+// to_cstrings<Base>(first, last, out, separator)
+//
+//  Formats each integral value in [first, last) in Base (default 10), with
+//  separator between them (but not after the last one), directly into the
+//  buffer starting at out, which must have room for
+//  to_cstrings_max_size<I, Base>(last - first) chars.  Returns the number of
+//  chars written (no '\0' is written).
+//
+//  The digits are the same as to_cstring<I, integral_constant<int, Base>>
+//  produces, as is the formatting core, but each value is written forwards
+//  in place (its length is computed up front from its bit width), instead
+//  of constructing a to_cstring and copying it out.
+//
+//  There is also an overload for boost::uuids::uuid, writing the same 36
+//  chars as to_cstring<boost::uuids::uuid> for each one (see uuid_chars.h).
+//
+//  This is intended for writing columns of numbers for CSV/TSV, etc.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+    // Maximum chars to_cstrings<Base> writes for n Is
+    template<typename I, int Base = 10>
+    constexpr size_t to_cstrings_max_size(size_t n) noexcept
+    {
+        size_t chars{0};
+        if constexpr(std::is_same_v<I, boost::uuids::uuid>)
+            chars = detail::uuid_chars;
+        else
+            chars = detail::max_chars<I, Base>();
+
+        return n ? n * (chars + sizeof(',')) - sizeof(',') : 0;
+    }
+
+    // Formats i into out, returning the end
+    template<int Base = 10, typename I>
+    constexpr char* to_cstrings(I i, char* out) noexcept
+    {
+        static_assert(detail::is_to_cstring_integral_v<I>);
+
+        if (i < I{})
+            *out++ = '-';
+
+        detail::magnitude_t<I> magnitude{detail::magnitude(i)};
+        char*                  last{out + detail::count_digits<Base>(magnitude)};
+        detail::format_backward<Base>(last, magnitude);
+
+        return last;
+    }
+
+    // Formats [first, last) into out, returning the number of chars written
+    template<int Base = 10, typename I>
+    constexpr size_t to_cstrings(I const* first, I const* last, char* out, char separator = ',') noexcept
+    {
+        if (first == last)
+            return 0;
+
+        char* o{to_cstrings<Base>(*first++, out)};
+        while (first != last)
+        {
+            *o++ = separator;
+            o = to_cstrings<Base>(*first++, o);
+        }
+
+        return static_cast<size_t>(o - out);
+    }
+
+    // Formats [first, last) uuids into out, returning the number of chars written
+    inline size_t to_cstrings(boost::uuids::uuid const* first, boost::uuids::uuid const* last, char* out, char separator = ',') noexcept
+    {
+        if (first == last)
+            return 0;
+
+        char* o{detail::format_uuid(first++->begin(), out)};
+        while (first != last)
+        {
+            *o++ = separator;
+            o = detail::format_uuid(first++->begin(), o);
+        }
+
+        return static_cast<size_t>(o - out);
+    }
+
+} // cool namespace
+
+#endif /* COOL_TO_CSTRINGS_H_ */
@@ -0,0 +1,256 @@
+#ifndef COOL_UUID_CHARS_H_
+#define COOL_UUID_CHARS_H_
+
+#include <cstddef>      // size_t
+#include <cstdint>      // uint8_t, uint32_t, uint_fast16_t
+#include <cstring>      // memcpy
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// uuid_chars
+//
+//  The uuid to characters (and back) conversion shared by
+//  to_cstring<boost::uuids::uuid>, from_cstring<boost::uuids::uuid>,
+//  to_cstrings and from_cstrings.  Works on the 16 bytes of the uuid and
+//  the 36 char 8-4-4-4-12 form (lowercase when formatting, either case when
+//  parsing), so it doesn't depend on boost.
+//
+//  format_uuid(bytes, out) writes exactly uuid_chars chars (no '\0').
+//  parse_uuid(in, bytes) reads exactly uuid_chars chars, and returns false
+//  (leaving bytes unspecified) unless they are a valid uuid.
+//
+//  The implementation is picked at compile time:
+//
+//      __SSSE3__   - nibbles become hex digits with one table lookup
+//                    (pshufb) for all 16 bytes, and the dashes are moved
+//                    into place with shuffles; parsing shuffles the dashes
+//                    out, then validates and converts all 32 hex digits at
+//                    once
+//      __SSE2__    - the same conversions and validation, but the dashes
+//                    are placed (or removed) by copying the 8-4-4-4-12
+//                    groups through a 32 char buffer
+//      otherwise   - one byte at a time (format_uuid_scalar and
+//                    parse_uuid_scalar, which are always available)
+//
+//  There is no AVX2 version, as a uuid only fills half of a 256-bit
+//  register and the cross-lane shuffles cost more than they save.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace cool
+{
+namespace detail
+{
+    // Number of chars in the 8-4-4-4-12 form of a uuid
+    inline constexpr size_t uuid_chars{16 * 2 + sizeof("----") - 1};
+
+    // Bit n is set if a '-' follows byte n
+    inline constexpr uint_fast16_t uuid_dashes{0b1010101000};
+
+    // values[c] is the value of c as a hex digit (either case), or 16 if it isn't one
+    struct hex_digit_values
+    {
+        constexpr hex_digit_values() noexcept
+        : values{}
+        {
+            for (auto& value : values)
+                value = 16;
+
+            for (uint8_t d = 0; d != 10; ++d)
+                values['0' + d] = d;
+
+            for (uint8_t d = 10; d != 16; ++d)
+                values['a' + d - 10] = values['A' + d - 10] = d;
+        }
+
+        constexpr uint8_t operator[](char c) const noexcept
+        { return values[static_cast<unsigned char>(c)]; }
+
+        uint8_t values[256];
+    };
+
+    inline constexpr hex_digit_values hex_digit_values_v{};
+
+    inline char* format_uuid_scalar(uint8_t const* bytes, char* out) noexcept
+    {
+        uint_fast16_t dashes{uuid_dashes};
+        for (uint8_t const* last = bytes + 16; bytes != last; ++bytes)
+        {
+            *out++ = "0123456789abcdef"[*bytes / 16];
+            *out++ = "0123456789abcdef"[*bytes % 16];
+            if (1 & dashes)
+                *out++ = '-';
+            dashes >>= 1;
+        }
+
+        return out;
+    }
+
+    inline bool parse_uuid_scalar(char const* in, uint8_t* bytes) noexcept
+    {
+        uint_fast16_t dashes{uuid_dashes};
+        for (uint8_t* last = bytes + 16; bytes != last; ++bytes)
+        {
+            unsigned high{hex_digit_values_v[*in++]};
+            unsigned low{hex_digit_values_v[*in++]};
+            if (16 <= high || 16 <= low)
+                return false;
+
+            *bytes = static_cast<uint8_t>(high * 16 + low);
+            if (1 & dashes && '-' != *in++)
+                return false;
+            dashes >>= 1;
+        }
+
+        return true;
+    }
+
+#if defined(__SSE2__)
+    // The hex digits for bytes[0..7] in first and bytes[8..15] in second
+    inline void uuid_hex_digits(__m128i bytes, __m128i& first, __m128i& second) noexcept
+    {
+        __m128i const mask{_mm_set1_epi8(0x0f)};
+        __m128i const high{_mm_and_si128(_mm_srli_epi16(bytes, 4), mask)};
+        __m128i const low{_mm_and_si128(bytes, mask)};
+
+    #if defined(__SSSE3__)
+        __m128i const digits{_mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                           '8', '9', 'a', 'b', 'c', 'd', 'e', 'f')};
+        __m128i const h{_mm_shuffle_epi8(digits, high)};
+        __m128i const l{_mm_shuffle_epi8(digits, low)};
+    #else
+        // n + '0', plus the gap between '9' and 'a' when 9 < n
+        auto const hex = [](__m128i n) noexcept
+        {
+            __m128i const letter{_mm_cmpgt_epi8(n, _mm_set1_epi8(9))};
+            return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')),
+                                _mm_and_si128(letter, _mm_set1_epi8('a' - '0' - 10)));
+        };
+        __m128i const h{hex(high)};
+        __m128i const l{hex(low)};
+    #endif
+
+        first  = _mm_unpacklo_epi8(h, l);
+        second = _mm_unpackhi_epi8(h, l);
+    }
+
+    // The bytes for the 32 hex digits in first and second, with validity in valid
+    inline __m128i uuid_hex_values(__m128i first, __m128i second, bool& valid) noexcept
+    {
+        auto const nibbles = [](__m128i c, __m128i& ok) noexcept
+        {
+            // c - '0' <= 9 for digits; (c | 0x20) - 'a' <= 5 for letters (either case)
+            __m128i const digit{_mm_sub_epi8(c, _mm_set1_epi8('0'))};
+            __m128i const letter{_mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'))};
+            __m128i const is_digit{_mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit)};
+            __m128i const is_letter{_mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter)};
+
+            ok = _mm_and_si128(ok, _mm_or_si128(is_digit, is_letter));
+            __m128i const n{_mm_or_si128(_mm_and_si128(is_digit, digit),
+                                         _mm_andnot_si128(is_digit, _mm_add_epi8(letter, _mm_set1_epi8(10))))};
+
+            // Each 16-bit lane holds high, low nibbles; combine them into its low byte
+            return _mm_and_si128(_mm_or_si128(_mm_slli_epi16(n, 4), _mm_srli_epi16(n, 8)),
+                                 _mm_set1_epi16(0x00ff));
+        };
+
+        __m128i       ok{_mm_set1_epi8(-1)};
+        __m128i const bytes{_mm_packus_epi16(nibbles(first, ok), nibbles(second, ok))};
+
+        valid = 0xffff == _mm_movemask_epi8(ok);
+        return bytes;
+    }
+#endif
+
+    inline char* format_uuid(uint8_t const* bytes, char* out) noexcept
+    {
+#if defined(__SSE2__)
+        __m128i first, second;
+        uuid_hex_digits(_mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes)), first, second);
+
+    #if defined(__SSSE3__)
+        // -1 (high bit set) selects 0, which the dashes are or'ed into
+        __m128i const dashes{_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0)};
+        __m128i const out0{_mm_or_si128(_mm_shuffle_epi8(first, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13)),
+                                        dashes)};
+        __m128i const out1{_mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(first,  _mm_setr_epi8(14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+            _mm_shuffle_epi8(second, _mm_setr_epi8(-1, -1, -1, 0, 1, 2, 3, -1, 4, 5, 6, 7, 8, 9, 10, 11))),
+            _mm_setr_epi8(0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0))};
+        uint32_t const out2{static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(second, 12)))};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), out0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), out1);
+        std::memcpy(out + 32, &out2, sizeof(out2));
+    #else
+        char digits[32];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(digits), first);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(digits + 16), second);
+
+        std::memcpy(out,      digits,      8);
+        out[8]  = '-';
+        std::memcpy(out + 9,  digits + 8,  4);
+        out[13] = '-';
+        std::memcpy(out + 14, digits + 12, 4);
+        out[18] = '-';
+        std::memcpy(out + 19, digits + 16, 4);
+        out[23] = '-';
+        std::memcpy(out + 24, digits + 20, 12);
+    #endif
+
+        return out + uuid_chars;
+#else
+        return format_uuid_scalar(bytes, out);
+#endif
+    }
+
+    inline bool parse_uuid(char const* in, uint8_t* bytes) noexcept
+    {
+#if defined(__SSE2__)
+        if ('-' != in[8] || '-' != in[13] || '-' != in[18] || '-' != in[23])
+            return false;
+
+    #if defined(__SSSE3__)
+        uint32_t in2;
+        std::memcpy(&in2, in + 32, sizeof(in2));
+        __m128i const in0{_mm_loadu_si128(reinterpret_cast<__m128i const*>(in))};
+        __m128i const in1{_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + 16))};
+
+        __m128i const first{_mm_or_si128(
+            _mm_shuffle_epi8(in0, _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 14, 15, -1, -1)),
+            _mm_shuffle_epi8(in1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1)))};
+        __m128i const second{_mm_or_si128(
+            _mm_shuffle_epi8(in1, _mm_setr_epi8(3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1)),
+            _mm_slli_si128(_mm_cvtsi32_si128(static_cast<int>(in2)), 12))};
+    #else
+        char digits[32];
+        std::memcpy(digits,      in,      8);
+        std::memcpy(digits + 8,  in + 9,  4);
+        std::memcpy(digits + 12, in + 14, 4);
+        std::memcpy(digits + 16, in + 19, 4);
+        std::memcpy(digits + 20, in + 24, 12);
+
+        __m128i const first{_mm_loadu_si128(reinterpret_cast<__m128i const*>(digits))};
+        __m128i const second{_mm_loadu_si128(reinterpret_cast<__m128i const*>(digits + 16))};
+    #endif
+
+        bool          valid;
+        __m128i const values{uuid_hex_values(first, second, valid)};
+        if (valid)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), values);
+
+        return valid;
+#else
+        return parse_uuid_scalar(in, bytes);
+#endif
+    }
+
+} // detail namespace
+} // cool namespace
+
+#endif /* COOL_UUID_CHARS_H_ */